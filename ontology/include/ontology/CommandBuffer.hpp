@@ -0,0 +1,137 @@
+// ----------------------------------------------------------------------------
+// CommandBuffer.hpp
+// ----------------------------------------------------------------------------
+
+#ifndef __ONTOLOGY_COMMAND_BUFFER_HPP__
+#define __ONTOLOGY_COMMAND_BUFFER_HPP__
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <ontology/Config.hpp>
+#include <ontology/Entity.hpp>
+#include <ontology/EntityManager.hpp>
+#include <ontology/World.hpp>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace Ontology {
+
+/*!
+ * @brief Records changes to a world to be applied later.
+ *
+ * Systems processing entities in parallel must not create or destroy
+ * entities, or add or remove components, as doing so would modify state
+ * shared by all threads. Instead, they record these changes with
+ * System::getCommandBuffer():
+ * @code
+ * void processEntity(Entity& entity) override
+ * {
+ *     if(entity.getComponent<Health>().value <= 0)
+ *         this->getCommandBuffer().destroyEntity(entity.getID());
+ * }
+ * @endcode
+ * Every chunk of entities records into its own buffer. The buffers are
+ * applied in the order of the chunks once the system finished its update, so
+ * the result doesn't depend on which thread processed which chunk.
+ */
+class ONTOLOGY_PUBLIC_API CommandBuffer
+{
+public:
+
+    typedef std::function<void(World&)> Command;
+
+    /*!
+     * @brief Records an arbitrary command.
+     */
+    void push(Command command);
+
+    /*!
+     * @brief Records creating an entity.
+     * @param name The name of the new entity. Must outlive the command.
+     * @param initialiser Called with the new entity, for instance to add
+     * components.
+     */
+    void createEntity(const char* name, std::function<void(Entity&)> initialiser=nullptr);
+
+    /*!
+     * @brief Records destroying an entity.
+     */
+    void destroyEntity(Entity::ID entity);
+
+    /*!
+     * @brief Records adding a component to an entity.
+     *
+     * The component is constructed right away and copied into the entity
+     * when the command is applied. Tag components (see IsTagComponent) carry
+     * no data and are simply added when the command is applied.
+     */
+    template <class T, class... Args>
+    void addComponent(Entity::ID entity, Args&&... args);
+
+    /*!
+     * @brief Records removing a component from an entity.
+     */
+    template <class T>
+    void removeComponent(Entity::ID entity);
+
+    /*!
+     * @brief Executes all recorded commands in order, then clears the buffer.
+     */
+    void apply(World& world);
+
+    /*!
+     * @brief Gets the number of recorded commands.
+     */
+    std::size_t size() const;
+
+private:
+
+    template <class T, class... Args>
+    void addComponentImpl(std::false_type, Entity::ID entity, Args&&... args);
+    template <class T>
+    void addComponentImpl(std::true_type, Entity::ID entity);
+
+    std::vector<Command> m_Commands;
+};
+
+// ----------------------------------------------------------------------------
+template <class T, class... Args>
+void CommandBuffer::addComponent(Entity::ID entity, Args&&... args)
+{
+    this->addComponentImpl<T>(IsTagComponent<T>(), entity, std::forward<Args>(args)...);
+}
+
+// ----------------------------------------------------------------------------
+template <class T, class... Args>
+void CommandBuffer::addComponentImpl(std::false_type, Entity::ID entity, Args&&... args)
+{
+    std::shared_ptr<T> component(new T(std::forward<Args>(args)...));
+    m_Commands.push_back([entity, component](World& world) {
+        world.getEntityManager().getEntity(entity).template addComponent<T>(*component);
+    });
+}
+
+// ----------------------------------------------------------------------------
+template <class T>
+void CommandBuffer::addComponentImpl(std::true_type, Entity::ID entity)
+{
+    m_Commands.push_back([entity](World& world) {
+        world.getEntityManager().getEntity(entity).template addComponent<T>();
+    });
+}
+
+// ----------------------------------------------------------------------------
+template <class T>
+void CommandBuffer::removeComponent(Entity::ID entity)
+{
+    m_Commands.push_back([entity](World& world) {
+        world.getEntityManager().getEntity(entity).template removeComponent<T>();
+    });
+}
+
+} // namespace Ontology
+
+#endif // __ONTOLOGY_COMMAND_BUFFER_HPP__
@@ -9,6 +9,9 @@
 // include files
 
 #include <ontology/Config.hpp>
+#include <ontology/TypeContainers.hpp>
+
+#include <type_traits>
 
 namespace Ontology {
 
@@ -47,6 +50,59 @@ protected:
     Component();
 };
 
+/*!
+ * @brief Detects tag components at compile time.
+ *
+ * A tag is a component that carries no data of its own, i.e. it derives from
+ * Component without adding any members:
+ * @code
+ * struct Player : public Ontology::Component {};
+ * @endcode
+ * Tags are never allocated. Adding one to an entity only sets a bit in the
+ * entity's signature, but they still participate in
+ * System::supportsComponents() like any other component.
+ */
+template <class T>
+struct IsTagComponent : public std::integral_constant<bool,
+    std::is_base_of<Component, T>::value && sizeof(T) == sizeof(Component)>
+{
+};
+
+/*!
+ * @brief Registers the shared instance of a tag type and returns its ID.
+ * @note Should not be called by the user. This is an internal function.
+ */
+ONTOLOGY_PUBLIC_API TypeID registerTagComponent(Component* instance);
+
+/*!
+ * @brief Gets the shared instance registered for the specified tag ID.
+ * @note Should not be called by the user. This is an internal function.
+ */
+ONTOLOGY_PUBLIC_API Component* getTagComponentInstance(TypeID tagID);
+
+/*!
+ * @brief Gets the one instance of a tag type shared by all entities.
+ *
+ * Tags have no state, so every entity carrying the tag can hand out a
+ * reference to the same object.
+ */
+template <class T>
+inline T& getTagComponentInstance()
+{
+    static T instance;
+    return instance;
+}
+
+/*!
+ * @brief Gets the dense ID of a tag type, used to index an entity's signature.
+ */
+template <class T>
+inline TypeID getTagComponentID()
+{
+    static const TypeID id = registerTagComponent(&getTagComponentInstance<T>());
+    return id;
+}
+
 } // namespace Ontology
 
 #endif // __ONTOLOGY_COMPONENT_HPP__
@@ -0,0 +1,55 @@
+// ----------------------------------------------------------------------------
+// Configuration.hpp
+// ----------------------------------------------------------------------------
+
+#ifndef __ONTOLOGY_CONFIGURATION_HPP__
+#define __ONTOLOGY_CONFIGURATION_HPP__
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <ontology/Component.hpp>
+
+#include <utility>
+
+namespace Ontology {
+
+/*!
+ * @brief Component holding the per-entity configuration of a system.
+ *
+ * A system that needs per-entity settings declares a nested Config type:
+ * @code
+ * struct MovementSystem : public Ontology::System
+ * {
+ *     struct Config
+ *     {
+ *         float maxSpeed;
+ *         bool canJump;
+ *     };
+ *     // ...
+ * };
+ * @endcode
+ * Entities are then configured with Entity::addConfiguration(), which stores
+ * the settings as a component private to that system. Because it's an
+ * ordinary component, a system can also require it:
+ * @code
+ * movementSystem.supportsComponents<
+ *     Position,
+ *     Ontology::Configuration<MovementSystem>>();
+ * @endcode
+ */
+template <class T>
+struct Configuration : public Component
+{
+    template <class... Args>
+    Configuration(Args&&... args) :
+        config{std::forward<Args>(args)...}
+    {
+    }
+
+    typename T::Config config;
+};
+
+} // namespace Ontology
+
+#endif // __ONTOLOGY_CONFIGURATION_HPP__
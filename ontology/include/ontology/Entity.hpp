@@ -9,6 +9,7 @@
 // include files
 
 #include <ontology/Component.hpp>
+#include <ontology/Configuration.hpp>
 #include <ontology/Entity.hxx>
 #include <ontology/EntityManager.hpp>
 #include <ontology/Exception.hpp>
@@ -16,25 +17,68 @@
 #include <ontology/World.hpp>
 #include <ontology/Type.hpp>
 
+#include <algorithm>
+
 namespace Ontology {
 
 //----------------------------------------------------------------------------
 template<class T, class... Args>
 Entity& Entity::addComponent(Args&&... args)
 {
-    ONTOLOGY_ASSERT(m_ComponentMap.find(&typeid(T)) == m_ComponentMap.end(), DuplicateComponentException, Entity::addComponent<T>,
+    ONTOLOGY_ASSERT(!this->hasComponent<T>(), DuplicateComponentException, Entity::addComponent<T>,
         std::string("Component of type \"") + getTypeName<T>() + "\" already registered with this entity"
     )
 
+    this->addComponentImpl<T>(IsTagComponent<T>(), std::forward<Args>(args)...);
+    return *this;
+}
+
+//----------------------------------------------------------------------------
+template<class T, class... Args>
+void Entity::addComponentImpl(std::false_type, Args&&... args)
+{
     Component* component = new T(args...);
     m_ComponentMap[&typeid(T)] = std::unique_ptr<Component>(component);
     m_Creator->informAddComponent(*this, component);
+}
+
+//----------------------------------------------------------------------------
+template<class T, class... Args>
+void Entity::addComponentImpl(std::true_type, Args&&...)
+{
+    static_assert(sizeof...(Args) == 0, "Tag components carry no data and can't be constructed with arguments");
+
+    this->setTag(getTagComponentID<T>(), true);
+    m_Creator->informAddComponent(*this, &getTagComponentInstance<T>());
+}
+
+//----------------------------------------------------------------------------
+template<class T, class... Args>
+Entity& Entity::addSharedComponent(Args&&... args)
+{
+    static_assert(!IsTagComponent<T>::value, "Tag components are never allocated, add them with addComponent()");
+    ONTOLOGY_ASSERT(!this->hasComponent<T>(), DuplicateComponentException, Entity::addSharedComponent<T>,
+        std::string("Component of type \"") + getTypeName<T>() + "\" already registered with this entity"
+    )
+
+    std::shared_ptr<Component> component = m_Creator->getSharedComponentPool()
+        .acquire<T>(std::forward<Args>(args)...);
+    m_ComponentMap[&typeid(T)] = component;
+    m_SharedComponents.push_back(&typeid(T));
+    m_Creator->informAddComponent(*this, component.get());
     return *this;
 }
 
 //----------------------------------------------------------------------------
 template<class T>
-void Entity::removeComponent()
+inline void Entity::removeComponent()
+{
+    this->removeComponentImpl<T>(IsTagComponent<T>());
+}
+
+//----------------------------------------------------------------------------
+template<class T>
+void Entity::removeComponentImpl(std::false_type)
 {
     const auto it = m_ComponentMap.find(&typeid(T));
     if(it == m_ComponentMap.end())
@@ -42,6 +86,23 @@ void Entity::removeComponent()
     
     m_Creator->informRemoveComponent(*this, it->second.get());
     m_ComponentMap.erase(it);
+    if(!m_SharedComponents.empty())
+        m_SharedComponents.erase(
+            std::remove(m_SharedComponents.begin(), m_SharedComponents.end(), &typeid(T)),
+            m_SharedComponents.end()
+        );
+}
+
+//----------------------------------------------------------------------------
+template<class T>
+void Entity::removeComponentImpl(std::true_type)
+{
+    const TypeID tagID = getTagComponentID<T>();
+    if(!this->hasTag(tagID))
+        return;
+
+    m_Creator->informRemoveComponent(*this, &getTagComponentInstance<T>());
+    this->setTag(tagID, false);
 }
 
 //----------------------------------------------------------------------------
@@ -53,18 +114,58 @@ inline T& Entity::getComponent() const
 
 //----------------------------------------------------------------------------
 template<class T>
-T* Entity::getComponentPtr() const
+inline T* Entity::getComponentPtr() const
+{
+    return this->getComponentPtrImpl<T>(IsTagComponent<T>());
+}
+
+//----------------------------------------------------------------------------
+template<class T>
+T* Entity::getComponentPtrImpl(std::false_type) const
 {
     const auto it = m_ComponentMap.find(&typeid(T));
     ONTOLOGY_ASSERT(it != m_ComponentMap.end(), InvalidComponentException, Entity::getComponent<T>,
         std::string("Component of type \"") + getTypeName<T>() + "\" not registered with this entity"
     )
+    ONTOLOGY_ASSERT(!this->isShared(&typeid(T)), SharedComponentException, Entity::getComponent<T>,
+        std::string("Component of type \"") + getTypeName<T>() + "\" is shared and read-only, use getSharedComponent()"
+    )
     return static_cast<T*>(it->second.get());
 }
 
 //----------------------------------------------------------------------------
 template <class T>
-bool Entity::hasComponent() const
+const T& Entity::getSharedComponent() const
+{
+    static_assert(!IsTagComponent<T>::value, "Tag components are never shared, access them with getComponent()");
+
+    const auto it = m_ComponentMap.find(&typeid(T));
+    ONTOLOGY_ASSERT(it != m_ComponentMap.end(), InvalidComponentException, Entity::getSharedComponent<T>,
+        std::string("Component of type \"") + getTypeName<T>() + "\" not registered with this entity"
+    )
+    return *static_cast<const T*>(it->second.get());
+}
+
+//----------------------------------------------------------------------------
+template<class T>
+T* Entity::getComponentPtrImpl(std::true_type) const
+{
+    ONTOLOGY_ASSERT(this->hasTag(getTagComponentID<T>()), InvalidComponentException, Entity::getComponent<T>,
+        std::string("Component of type \"") + getTypeName<T>() + "\" not registered with this entity"
+    )
+    return &getTagComponentInstance<T>();
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+inline bool Entity::hasComponent() const
+{
+    return this->hasComponentImpl<T>(IsTagComponent<T>());
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+bool Entity::hasComponentImpl(std::false_type) const
 {
     const auto it = m_ComponentMap.find(&typeid(T));
     if(it == m_ComponentMap.end())
@@ -72,6 +173,45 @@ bool Entity::hasComponent() const
     return true;
 }
 
+//----------------------------------------------------------------------------
+template <class T>
+inline bool Entity::hasComponentImpl(std::true_type) const
+{
+    return this->hasTag(getTagComponentID<T>());
+}
+
+//----------------------------------------------------------------------------
+inline bool Entity::hasTag(TypeID tagID) const
+{
+    if(tagID < InlineTagCount)
+        return (m_TagSignature >> tagID) & 1;
+    tagID -= InlineTagCount;
+    return tagID < m_TagOverflow.size() && m_TagOverflow[tagID];
+}
+
+//----------------------------------------------------------------------------
+inline bool Entity::isShared(const std::type_info* type) const
+{
+    return std::find(m_SharedComponents.begin(), m_SharedComponents.end(), type) != m_SharedComponents.end();
+}
+
+//----------------------------------------------------------------------------
+inline void Entity::setTag(TypeID tagID, bool value)
+{
+    if(tagID < InlineTagCount)
+    {
+        const std::uint64_t bit = std::uint64_t(1) << tagID;
+        m_TagSignature = (value ? m_TagSignature | bit : m_TagSignature & ~bit);
+        return;
+    }
+
+    // only entities carrying more tag types than fit inline allocate
+    tagID -= InlineTagCount;
+    if(m_TagOverflow.size() <= tagID)
+        m_TagOverflow.resize(tagID + 1, false);
+    m_TagOverflow[tagID] = value;
+}
+
 //----------------------------------------------------------------------------
 template <class T>
 Entity& Entity::configure(std::string param)
@@ -84,6 +224,27 @@ Entity& Entity::configure(std::string param)
     return *this;
 }
 
+//----------------------------------------------------------------------------
+template <class T, class... Args>
+inline Entity& Entity::addConfiguration(Args&&... args)
+{
+    return this->addComponent< Configuration<T> >(std::forward<Args>(args)...);
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+inline typename T::Config& Entity::getConfiguration() const
+{
+    return this->getComponent< Configuration<T> >().config;
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+inline bool Entity::hasConfiguration() const
+{
+    return this->hasComponent< Configuration<T> >();
+}
+
 } // namespace Ontology
 
 #endif // __ONTOLOGY_ENTITY_HPP__
@@ -11,7 +11,9 @@
 #include <ontology/Config.hpp>
 #include <ontology/TypeContainers.hpp>
 
+#include <cstdint>
 #include <map>
+#include <type_traits>
 #include <typeinfo>
 #include <string>
 #include <cassert>
@@ -22,6 +24,7 @@
 
 namespace Ontology{
     class Component;
+    class EntityListener;
     struct EntityManagerInterface;
     class System;
 }
@@ -58,6 +61,10 @@ public:
 
     /*!
      * @brief Construct an entity with a name.
+     *
+     * Only a pointer to the name is stored, so the creator must keep it
+     * alive for the lifetime of the entity. EntityManager stores every
+     * distinct name once and releases it with the last entity carrying it.
      */
     Entity(const char* name, const EntityManagerInterface* creator);
 
@@ -78,11 +85,33 @@ public:
      * @endcode
      *
      * @note You can only register one instance of every type of component.
+     * @note Tag components (see IsTagComponent) are not allocated. They are
+     * only recorded in the entity's signature.
      * @return Returns a reference to this Entity. This is to allow chaining.
      */
     template<class T, class... Args>
     Entity& addComponent(Args&&...);
 
+    /*!
+     * @brief Add a component whose value is shared with other entities.
+     *
+     * Works like Entity::addComponent(), except that if any other entity of
+     * the same world already references an equal value (compared with
+     * operator==), this entity references that instance instead of
+     * allocating its own copy:
+     * @code
+     * myEntity.addSharedComponent<Material>("res/stone.png", 0.5f);
+     * @endcode
+     * Modifying the shared value would modify it for every entity
+     * referencing it, so it is read-only and retrieved with
+     * Entity::getSharedComponent(). Entity::getComponent() refuses to hand
+     * it out.
+     * @see SharedComponentPool
+     * @return Returns a reference to this Entity. This is to allow chaining.
+     */
+    template<class T, class... Args>
+    Entity& addSharedComponent(Args&&...);
+
     /*!
      * @brief Remove a component from this entity.
      * 
@@ -96,10 +125,21 @@ public:
 
     /*!
      * @brief Get a component from the entity.
+     * @note Shared components are read-only, see Entity::getSharedComponent().
      * @return A reference to the requested component.
      */
     template <class T>
     inline T& getComponent() const;
+
+    /*!
+     * @brief Get read-only access to a component from the entity.
+     *
+     * Works for every component, but is the only way to access a component
+     * added with Entity::addSharedComponent().
+     * @return A const reference to the requested component.
+     */
+    template <class T>
+    inline const T& getSharedComponent() const;
     
     /*!
      * @brief Get a component from the entity.
@@ -117,10 +157,41 @@ public:
     
     /*!
      * @brief Tells the specified system to configure this entity.
+     * @note Every call constructs a string the system has to parse. Prefer
+     * Entity::addConfiguration() for systems that declare a Config type.
      */
     template <class T>
     Entity& configure(std::string param="");
 
+    /*!
+     * @brief Stores the specified system's typed configuration for this entity.
+     *
+     * The system type is passed as a template argument and must declare a
+     * nested Config type. The arguments are used to initialise it:
+     * @code
+     * myEntity.addConfiguration<MovementSystem>(4.5f, true);
+     * @endcode
+     * The system retrieves it with Entity::getConfiguration(). No system
+     * lookup, string construction or parsing is involved.
+     * @see Configuration
+     * @return Returns a reference to this Entity. This is to allow chaining.
+     */
+    template <class T, class... Args>
+    Entity& addConfiguration(Args&&...);
+
+    /*!
+     * @brief Gets the specified system's typed configuration for this entity.
+     * @return A reference to the requested configuration.
+     */
+    template <class T>
+    inline typename T::Config& getConfiguration() const;
+
+    /*!
+     * @brief Checks if this entity was configured for the specified system.
+     */
+    template <class T>
+    inline bool hasConfiguration() const;
+
     /*!
      * @brief Returns true if this entity is supported by the specified system.
      *
@@ -131,9 +202,41 @@ public:
      */
     bool supportsSystem(const System&) const;
 
+    /*!
+     * @brief Registers a listener to be notified of changes to this entity.
+     *
+     * Listeners are stored by the entity manager that created the entity,
+     * entities without listeners carry no additional state.
+     * @see EntityListener
+     * @return Returns a reference to this Entity. This is to allow chaining.
+     */
+    Entity& addListener(EntityListener* listener);
+
+    /*!
+     * @brief Unregisters a listener from this entity.
+     *
+     * Events still waiting to be delivered to the listener are discarded.
+     */
+    void removeListener(EntityListener* listener);
+
+    /*!
+     * @brief Gets a handle keeping the specified component of this entity
+     * alive, even after it was removed.
+     * @note Should not be called by the user. This is an internal function.
+     */
+    ONTOLOGY_LOCAL_API std::shared_ptr<const Component> getComponentHandle(const Component* component) const;
+
+    /*!
+     * @brief Exchanges the contents of two entities without copying their
+     * components or dispatching any events.
+     * @note Should not be called by the user. This is an internal function.
+     */
+    ONTOLOGY_LOCAL_API void swap(Entity& other);
+
     /*!
      * @brief Gets the name of the entity.
-     * @return A const char pointer to the entity's name string.
+     * @return A const char pointer to the entity's name string, owned by its EntityManager.
+     * Entities of one manager with equal names return the same pointer.
      */
     const char* getName() const;
     
@@ -144,9 +247,50 @@ public:
 
 private:
 
+    template <class T, class... Args>
+    void addComponentImpl(std::false_type, Args&&...);
+    template <class T, class... Args>
+    void addComponentImpl(std::true_type, Args&&...);
+
+    template <class T>
+    void removeComponentImpl(std::false_type);
+    template <class T>
+    void removeComponentImpl(std::true_type);
+
+    template <class T>
+    T* getComponentPtrImpl(std::false_type) const;
+    template <class T>
+    T* getComponentPtrImpl(std::true_type) const;
+
+    template <class T>
+    bool hasComponentImpl(std::false_type) const;
+    template <class T>
+    bool hasComponentImpl(std::true_type) const;
+
+    /*!
+     * @brief Checks the entity's signature for the specified tag.
+     */
+    inline bool hasTag(TypeID tagID) const;
+
+    /*!
+     * @brief Sets or clears a tag in the entity's signature.
+     */
+    inline void setTag(TypeID tagID, bool value);
+
+    /*!
+     * @brief Checks if the component of the specified type is shared.
+     */
+    inline bool isShared(const std::type_info* type) const;
+
+    /// The number of tag types stored without allocating.
+    static const TypeID InlineTagCount = 64;
+
     static ID                       GUIDCounter;
     ID                              m_ID;
     TypeMapSharedPtr<Component>     m_ComponentMap;
+    std::uint64_t                   m_TagSignature;
+    std::vector<bool>               m_TagOverflow;
+    std::vector<const std::type_info*> m_SharedComponents;
     const char*                     m_Name;
     const EntityManagerInterface*   m_Creator;
 };
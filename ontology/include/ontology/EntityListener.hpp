@@ -8,9 +8,28 @@
 // ----------------------------------------------------------------------------
 // include files
 
+#include <ontology/Config.hpp>
+#include <ontology/Entity.hxx>
+
+// ----------------------------------------------------------------------------
+// forward declarations
+
 namespace Ontology {
+    class Component;
+}
 
-class EntityListener
+namespace Ontology {
+
+/*!
+ * @brief Listener interface for classes observing specific entities.
+ *
+ * Unlike an EntityManagerListener, which is told about every entity, an
+ * EntityListener is registered to individual entities with
+ * Entity::addListener(). Events are collected while systems run and delivered
+ * in batch when a system finished its update, and at the start of
+ * World::update(). Entities without listeners don't pay for any of this.
+ */
+class ONTOLOGY_PUBLIC_API EntityListener
 {
 public:
 
@@ -20,10 +39,31 @@ public:
     virtual ~EntityListener()
     {}
 
-    virtual void onAddComponent(const Component*)
+    /*!
+     * @brief Called when an observed entity added a component.
+     * @param entity The ID of the entity.
+     * @param component The component that was added.
+     */
+    virtual void onAddComponent(Entity::ID, const Component*)
     {}
 
-    virtual void onRemoveComponent(const Component*)
+    /*!
+     * @brief Called when an observed entity removed a component.
+     * @param entity The ID of the entity.
+     * @param component The component that was removed. It is kept alive until
+     * the listener returns.
+     */
+    virtual void onRemoveComponent(Entity::ID, const Component*)
+    {}
+
+    /*!
+     * @brief Called when an observed entity was destroyed.
+     *
+     * The listener is unregistered from the entity afterwards. No remove
+     * component events are delivered for the components the entity had.
+     * @param entity The ID of the destroyed entity.
+     */
+    virtual void onDestroyEntity(Entity::ID)
     {}
 };
 
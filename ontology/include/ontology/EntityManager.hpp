@@ -11,9 +11,16 @@
 #include <ontology/Config.hpp>
 #include <ontology/EntityManagerInterface.hpp>
 #include <ontology/ListenerDispatcher.hpp>
+#include <ontology/SharedComponentPool.hpp>
+#include <ontology/TypeContainers.hpp>
 
+#include <cstdint>
+#include <functional>
 #include <vector>
 #include <memory>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
 
 // ----------------------------------------------------------------------------
 // forward declarations
@@ -21,6 +28,7 @@
 namespace Ontology {
     class Component;
     class Entity;
+    class EntityListener;
     class EntityManagerListener;
 }
 
@@ -70,12 +78,18 @@ public:
 
     /*!
      * @brief Destroys the specified entity.
+     *
+     * The last entity of the list takes the destroyed entity's place, so
+     * destroying doesn't shift the remaining entities.
      * @param entity The entity to destroy.
      */
     void destroyEntity(Entity& entity) override;
 
     /*!
      * @brief Destroys all entities sharing the specified name.
+     *
+     * Entities are indexed by name, so finding them costs time proportional
+     * to the number of matches rather than the number of entities.
      * @param name The name to search for.
      */
     void destroyEntities(const char* name) override;
@@ -96,6 +110,20 @@ public:
      */
     Entity& getEntity(Entity::ID entityID) override;
 
+    /*!
+     * @brief Gets the IDs of all entities sharing the specified name.
+     * @param name The name to search for.
+     * @return The IDs in the order the entities were created. The returned
+     * reference is invalidated when entities are created or destroyed.
+     */
+    const std::vector<Entity::ID>& getEntityIDs(const char* name) const;
+
+    /*!
+     * @brief Gets the pool deduplicating shared components of this manager's entities.
+     * @see Entity::addSharedComponent
+     */
+    SharedComponentPool& getSharedComponentPool() const override;
+
     /*!
      * @brief Gets a list of entities of type EntityManager::EntityList.
      *
@@ -108,8 +136,98 @@ public:
      */
     ListenerDispatcher<EntityManagerListener> event;
 
+    /*!
+     * @brief Registers a listener for components of the specified types only.
+     *
+     * Unlike listeners registered with EntityManager::event, the listener's
+     * EntityManagerListener::onAddComponent() and
+     * EntityManagerListener::onRemoveComponent() are only called for
+     * components of the specified types. Events are routed through a list of
+     * listeners per type, so listeners interested in few components don't pay
+     * for all others.
+     * @code
+     * world.getEntityManager().addComponentListener<Health>(&healthBar);
+     * @endcode
+     * @note Filtered listeners receive no other events.
+     */
+    template <class... T>
+    void addComponentListener(EntityManagerListener* listener);
+
+    /*!
+     * @brief Registers a listener for components of the specified types only.
+     */
+    void addComponentListener(EntityManagerListener* listener, const TypeVector& componentTypes);
+
+    /*!
+     * @brief Unregisters a listener from all component types.
+     */
+    void removeComponentListener(EntityManagerListener* listener);
+
+    /*!
+     * @brief Registers a listener to be notified of changes to one entity.
+     * @see Entity::addListener()
+     */
+    void addEntityListener(Entity::ID entity, EntityListener* listener) const override;
+
+    /*!
+     * @brief Unregisters a listener from one entity.
+     * @see Entity::removeListener()
+     */
+    void removeEntityListener(Entity::ID entity, EntityListener* listener) const override;
+
+    /*!
+     * @brief Delivers all queued events to entity listeners.
+     *
+     * This is called whenever a system finished its update and at the start
+     * of World::update(). Call it manually to deliver changes made outside
+     * of an update right away.
+     */
+    void dispatchEntityEvents();
+
+    /*!
+     * @brief Sorts a range of the entity list by a key.
+     *
+     * Entities are swapped in place, their components aren't copied and no
+     * component events are dispatched. IDs keep referring to the same
+     * entities, and listeners are told which entities moved where through
+     * EntityManagerListener::onEntitiesMoved(). Systems fix up their
+     * references without changing the order they process entities in.
+     * @param first The position of the first entity to sort.
+     * @param last The position after the last entity to sort.
+     * @param key Computes the key of an entity. Entities with equal keys keep
+     * their relative order.
+     * @return False if the range was already sorted and nothing moved.
+     */
+    bool reorderEntities(std::size_t first, std::size_t last, const std::function<std::uint64_t(const Entity&)>& key);
+
 private:
 
+    struct EntityEvent
+    {
+        enum Type
+        {
+            AddComponent,
+            RemoveComponent,
+            DestroyEntity
+        };
+
+        Type                                type;
+        EntityListener*                     listener;
+        Entity::ID                          entity;
+        std::shared_ptr<const Component>    component;
+    };
+
+    /*!
+     * @brief Queues an event for every listener of the entity.
+     */
+    void queueEntityEvent(EntityEvent::Type type, const Entity& entity, const Component* component) const;
+
+    /*!
+     * @brief Queues destroy events for the listeners of the entity and
+     * unregisters them.
+     */
+    void releaseEntityListeners(Entity::ID entity);
+
     /*!
      * @brief Called by entities when they add a new component.
      * @param entity The entity adding a new component.
@@ -129,10 +247,36 @@ private:
      */
     void handleEntityReallocation(bool force=false);
 
+    /*!
+     * @brief Destroys the entity at the specified position by moving the last
+     * entity into its place. The name index is left to the caller.
+     */
+    void destroyEntityAt(std::size_t position);
+
+    typedef std::unordered_map<Entity::ID, std::size_t> EntityIndex;
+    typedef std::unordered_map<std::string, std::vector<Entity::ID>> NameIndex;
+    typedef std::unordered_map<const std::type_info*, std::vector<EntityManagerListener*>> ComponentListenerMap;
+    typedef std::unordered_map<Entity::ID, std::vector<EntityListener*>> EntityListenerMap;
+
     EntityList m_EntityList;
+    mutable SharedComponentPool m_SharedComponentPool;
+    EntityIndex m_EntityIndex;
+    NameIndex m_NameIndex;
+    ComponentListenerMap m_ComponentListeners;
+    mutable EntityListenerMap m_EntityListeners;
+    mutable std::vector<EntityEvent> m_EntityEvents;
+    bool m_RelocatingEntities;
+    bool m_ReleasingDestroyedEntity;
     std::size_t m_EntityListCapacity;
 };
 
+// ----------------------------------------------------------------------------
+template <class... T>
+void EntityManager::addComponentListener(EntityManagerListener* listener)
+{
+    this->addComponentListener(listener, TypeVector({&typeid(T)...}));
+}
+
 } // namespace Ontology
 
 #endif // __ONTOLOGY_ENTITY_MANAGER_HPP__
@@ -15,6 +15,8 @@ namespace Ontology {
 
 class Component;
 class Entity;
+class EntityListener;
+class SharedComponentPool;
 class World;
 
 struct EntityManagerInterface
@@ -28,6 +30,9 @@ struct EntityManagerInterface
     virtual Entity& getEntity(Entity::ID) = 0;
     ONTOLOGY_LOCAL_API virtual void informAddComponent(Entity& entity, const Component* component) const = 0;
     ONTOLOGY_LOCAL_API virtual void informRemoveComponent(Entity& entity, const Component* component) const = 0;
+    virtual void addEntityListener(Entity::ID entity, EntityListener* listener) const = 0;
+    virtual void removeEntityListener(Entity::ID entity, EntityListener* listener) const = 0;
+    virtual SharedComponentPool& getSharedComponentPool() const = 0;
     World* world;
 };
 
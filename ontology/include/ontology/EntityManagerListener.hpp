@@ -10,6 +10,7 @@
 
 #include <ontology/Config.hpp>
 
+#include <cstddef>
 #include <vector>
 
 // ----------------------------------------------------------------------------
@@ -59,6 +60,19 @@ public:
      * @brief Called when EntityManager has re-allocated the memory for its entities
      */
     virtual void onEntitiesReallocated(std::vector<Entity>& entityList);
+
+    /*!
+     * @brief Called when EntityManager moved some entities to other positions
+     * without re-allocating.
+     *
+     * The entity that was at position first+i is now at destinations[i]. All
+     * other entities stayed where they were. The default implementation
+     * forwards to onEntitiesReallocated().
+     * @param entityList The entities after moving.
+     * @param first The old position of the first moved entity.
+     * @param destinations The new positions of the moved entities.
+     */
+    virtual void onEntitiesMoved(std::vector<Entity>& entityList, std::size_t first, const std::vector<std::size_t>& destinations);
 };
 
 } // namespace Ontology
@@ -0,0 +1,320 @@
+// ----------------------------------------------------------------------------
+// EventChannel.hpp
+// ----------------------------------------------------------------------------
+
+#ifndef __ONTOLOGY_EVENT_CHANNEL_HPP__
+#define __ONTOLOGY_EVENT_CHANNEL_HPP__
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <ontology/Config.hpp>
+
+#include <atomic>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Ontology {
+
+/*!
+ * @brief Interface the World uses to advance its event channels every frame.
+ */
+class ONTOLOGY_PUBLIC_API EventChannelBase
+{
+public:
+
+    virtual ~EventChannelBase() {}
+
+    /*!
+     * @brief Moves the events of the current frame into the previous frame's
+     * buffer, discarding the events of the previous frame.
+     */
+    virtual void swapBuffers() = 0;
+
+    /*!
+     * @brief Appends events posted from other threads to the current frame.
+     */
+    virtual void flush() = 0;
+};
+
+/*!
+ * @brief Stores events of one type in contiguous, double buffered storage.
+ *
+ * Instead of notifying every listener with a virtual call per event,
+ * producing systems append events to the channel and consuming systems
+ * iterate all of them in bulk later on:
+ * @code
+ * // CollisionSystem
+ * world->events<Collision>().send(Collision(a, b));
+ *
+ * // DamageSystem, executes after CollisionSystem
+ * for(const auto& collision : world->events<Collision>().get())
+ *     // ...
+ * @endcode
+ * At the end of World::update(), the events of the current frame become the
+ * events of the previous frame. Systems executing before the producer in a
+ * frame read the previous frame's events with EventChannel::getPrevious(),
+ * so no event is missed regardless of the execution order.
+ *
+ * EventChannel::send() is not thread safe. Threads other than the one
+ * updating the world, such as worker threads processing entities in
+ * parallel or a network thread, publish with EventChannel::post() instead.
+ * Every posting thread appends to its own segment of the channel without
+ * locking, and the segments are appended to the current frame at the next
+ * sync point: when a system finished its update, and at the start of
+ * World::update().
+ * @note Events posted by different threads are appended in no particular
+ * order. Events posted by the same thread keep their order.
+ */
+template <class T>
+class EventChannel : public EventChannelBase
+{
+public:
+
+    /*!
+     * @brief Default constructor.
+     */
+    EventChannel();
+
+    /*!
+     * @brief Destroys events that were posted but never flushed.
+     */
+    ~EventChannel();
+
+    EventChannel(const EventChannel&) = delete;
+    EventChannel& operator=(const EventChannel&) = delete;
+
+    /*!
+     * @brief Appends an event to the current frame.
+     */
+    void send(const T& event);
+
+    /*!
+     * @brief Appends an event to the current frame.
+     */
+    void send(T&& event);
+
+    /*!
+     * @brief Publishes an event from any thread.
+     * @note This function is thread safe and lock-free.
+     */
+    void post(T event);
+
+    /*!
+     * @brief Constructs an event in place at the end of the current frame.
+     */
+    template <class... Args>
+    void emplace(Args&&... args);
+
+    /*!
+     * @brief Gets the events sent during the current frame.
+     */
+    const std::vector<T>& get() const;
+
+    /*!
+     * @brief Gets the events sent during the previous frame.
+     */
+    const std::vector<T>& getPrevious() const;
+
+    void swapBuffers() override;
+    void flush() override;
+
+private:
+
+    static const std::size_t ChunkSize = 64;
+
+    // events are posted into fixed size chunks, so a thread only allocates
+    // once per ChunkSize events, and not at all once it reuses spare chunks
+    struct Chunk
+    {
+        Chunk() : count(0), next(nullptr) {}
+
+        T* at(std::size_t i) { return reinterpret_cast<T*>(&events[i]); }
+
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type events[ChunkSize];
+        std::atomic<std::size_t>    count;
+        std::atomic<Chunk*>         next;
+    };
+
+    // the events posted by a single thread. Only that thread appends to the
+    // tail, and only flush() consumes from the head.
+    struct Segment
+    {
+        explicit Segment(std::thread::id thread) :
+            thread(thread), head(new Chunk), read(0), tail(head), spare(nullptr), next(nullptr) {}
+
+        std::thread::id     thread;
+        Chunk*              head;
+        std::size_t         read;
+        Chunk*              tail;
+        std::atomic<Chunk*> spare;
+        Segment*            next;
+    };
+
+    Segment* getLocalSegment();
+
+    std::vector<T>          m_Current;
+    std::vector<T>          m_Previous;
+    std::atomic<Segment*>   m_Segments;
+};
+
+// ----------------------------------------------------------------------------
+template <class T>
+EventChannel<T>::EventChannel() :
+    m_Segments(nullptr)
+{
+}
+
+// ----------------------------------------------------------------------------
+template <class T>
+EventChannel<T>::~EventChannel()
+{
+    Segment* segment = m_Segments.load();
+    while(segment)
+    {
+        Chunk* chunk = segment->head;
+        std::size_t read = segment->read;
+        while(chunk)
+        {
+            for(std::size_t i = read; i != chunk->count.load(); ++i)
+                chunk->at(i)->~T();
+            Chunk* next = chunk->next.load();
+            delete chunk;
+            chunk = next;
+            read = 0;
+        }
+        delete segment->spare.load();
+
+        Segment* next = segment->next;
+        delete segment;
+        segment = next;
+    }
+}
+
+// ----------------------------------------------------------------------------
+template <class T>
+void EventChannel<T>::send(const T& event)
+{
+    m_Current.push_back(event);
+}
+
+// ----------------------------------------------------------------------------
+template <class T>
+void EventChannel<T>::send(T&& event)
+{
+    m_Current.push_back(std::move(event));
+}
+
+// ----------------------------------------------------------------------------
+template <class T>
+void EventChannel<T>::post(T event)
+{
+    Segment* segment = this->getLocalSegment();
+    Chunk* chunk = segment->tail;
+    std::size_t count = chunk->count.load(std::memory_order_relaxed);
+    if(count == ChunkSize)
+    {
+        // flush() hands back chunks it consumed, reuse one if available
+        Chunk* next = segment->spare.exchange(nullptr, std::memory_order_acquire);
+        if(next == nullptr)
+            next = new Chunk;
+        chunk->next.store(next, std::memory_order_release);
+        segment->tail = chunk = next;
+        count = 0;
+    }
+
+    // publishing the new count makes the event visible to flush()
+    new(chunk->at(count)) T(std::move(event));
+    chunk->count.store(count + 1, std::memory_order_release);
+}
+
+// ----------------------------------------------------------------------------
+template <class T>
+template <class... Args>
+void EventChannel<T>::emplace(Args&&... args)
+{
+    m_Current.emplace_back(std::forward<Args>(args)...);
+}
+
+// ----------------------------------------------------------------------------
+template <class T>
+const std::vector<T>& EventChannel<T>::get() const
+{
+    return m_Current;
+}
+
+// ----------------------------------------------------------------------------
+template <class T>
+const std::vector<T>& EventChannel<T>::getPrevious() const
+{
+    return m_Previous;
+}
+
+// ----------------------------------------------------------------------------
+template <class T>
+void EventChannel<T>::swapBuffers()
+{
+    // swapping keeps the capacity of both buffers, so channels stop
+    // allocating once they have seen their busiest frame
+    m_Previous.swap(m_Current);
+    m_Current.clear();
+}
+
+// ----------------------------------------------------------------------------
+template <class T>
+void EventChannel<T>::flush()
+{
+    for(Segment* segment = m_Segments.load(std::memory_order_acquire); segment; segment = segment->next)
+    {
+        while(true)
+        {
+            Chunk* chunk = segment->head;
+            const std::size_t count = chunk->count.load(std::memory_order_acquire);
+            for(; segment->read != count; ++segment->read)
+            {
+                T* event = chunk->at(segment->read);
+                m_Current.push_back(std::move(*event));
+                event->~T();
+            }
+
+            // the posting thread no longer touches a full chunk once it
+            // linked the next one
+            Chunk* next = chunk->next.load(std::memory_order_acquire);
+            if(count != ChunkSize || next == nullptr)
+                break;
+            segment->head = next;
+            segment->read = 0;
+
+            chunk->count.store(0, std::memory_order_relaxed);
+            chunk->next.store(nullptr, std::memory_order_relaxed);
+            Chunk* spare = nullptr;
+            if(!segment->spare.compare_exchange_strong(spare, chunk, std::memory_order_release, std::memory_order_relaxed))
+                delete chunk;
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+template <class T>
+typename EventChannel<T>::Segment* EventChannel<T>::getLocalSegment()
+{
+    const std::thread::id thread = std::this_thread::get_id();
+    Segment* first = m_Segments.load(std::memory_order_acquire);
+    for(Segment* segment = first; segment; segment = segment->next)
+        if(segment->thread == thread)
+            return segment;
+
+    // only the calling thread adds a segment for itself, so it can't have
+    // been added concurrently
+    Segment* segment = new Segment(thread);
+    segment->next = first;
+    while(!m_Segments.compare_exchange_weak(segment->next, segment, std::memory_order_release, std::memory_order_relaxed)) {}
+    return segment;
+}
+
+} // namespace Ontology
+
+#endif // __ONTOLOGY_EVENT_CHANNEL_HPP__
@@ -44,6 +44,11 @@ DECLARE_EXCEPTION(CircularDependencyException)
 DECLARE_EXCEPTION(DuplicateSystemException)
 DECLARE_EXCEPTION(InvalidSystemException)
 DECLARE_EXCEPTION(InvalidEntityException)
+DECLARE_EXCEPTION(DuplicateSingletonException)
+DECLARE_EXCEPTION(InvalidSingletonException)
+DECLARE_EXCEPTION(InvalidParentException)
+DECLARE_EXCEPTION(InvalidSpatialIndexException)
+DECLARE_EXCEPTION(SharedComponentException)
 
 #   define STRINGIFY(x) #x
 #   define TO_STRING(x) STRINGIFY(x)
@@ -0,0 +1,211 @@
+// ----------------------------------------------------------------------------
+// FrameAllocator.hpp
+// ----------------------------------------------------------------------------
+
+#ifndef __ONTOLOGY_FRAME_ALLOCATOR_HPP__
+#define __ONTOLOGY_FRAME_ALLOCATOR_HPP__
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <ontology/Config.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Ontology {
+
+/*!
+ * @brief Hands out memory by bumping a pointer, and frees it all at once.
+ *
+ * Allocating is a few instructions and individual allocations are never
+ * freed, which makes the arena a good fit for scratch data that lives for a
+ * single frame. Once a block is exhausted, a larger one is allocated. After
+ * LinearArena::reset(), the blocks are merged into one, so a frame using the
+ * same amount of memory as the previous one doesn't touch the heap.
+ * @note A LinearArena must only be used by one thread at a time.
+ */
+class ONTOLOGY_PUBLIC_API LinearArena
+{
+public:
+
+    /*!
+     * @brief Constructs an empty arena.
+     * @param blockSize The size of the first block, allocated when first
+     * needed.
+     */
+    explicit LinearArena(std::size_t blockSize=DefaultBlockSize);
+
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    /*!
+     * @brief Allocates uninitialised memory.
+     * @param size The number of bytes.
+     * @param alignment The alignment of the memory. Must be a power of two.
+     */
+    void* allocate(std::size_t size, std::size_t alignment=alignof(std::max_align_t));
+
+    /*!
+     * @brief Allocates uninitialised memory for an array of objects.
+     */
+    template <class T>
+    T* allocate(std::size_t count);
+
+    /*!
+     * @brief Frees all allocations.
+     * @note Destructors of objects constructed in the arena are not called.
+     */
+    void reset();
+
+    /*!
+     * @brief Gets the number of bytes allocated since the last reset.
+     */
+    std::size_t getUsed() const;
+
+    /*!
+     * @brief Gets the number of bytes the arena can hand out without
+     * allocating another block.
+     */
+    std::size_t getCapacity() const;
+
+    static const std::size_t DefaultBlockSize = 64 * 1024;
+
+private:
+
+    struct Block
+    {
+        std::unique_ptr<char[]> data;
+        std::size_t             size;
+    };
+
+    void addBlock(std::size_t size);
+
+    std::vector<Block>  m_Blocks;
+    std::size_t         m_BlockSize;
+    std::size_t         m_Offset;
+    std::size_t         m_Used;
+};
+
+/*!
+ * @brief Owns one LinearArena per thread, all reset at the same time.
+ *
+ * The world resets its frame allocator at the end of every World::update(),
+ * so systems can allocate transient data without going through the heap and
+ * without any synchronisation between threads:
+ * @code
+ * void processEntity(Entity& entity) override
+ * {
+ *     LinearArena& arena = world->getFrameAllocator().local();
+ *     Contact* contacts = arena.allocate<Contact>(maxContacts);
+ *     // ...
+ * }
+ * @endcode
+ * @see ArenaAllocator
+ */
+class ONTOLOGY_PUBLIC_API FrameAllocator
+{
+public:
+
+    /*!
+     * @brief Default constructor.
+     */
+    FrameAllocator();
+
+    FrameAllocator(const FrameAllocator&) = delete;
+    FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+    /*!
+     * @brief Gets the arena of the calling thread.
+     * @note This function is thread safe.
+     */
+    LinearArena& local();
+
+    /*!
+     * @brief Frees all allocations of all threads.
+     * @note No thread may use memory allocated from this allocator afterwards.
+     */
+    void reset();
+
+    /*!
+     * @brief Gets the number of bytes allocated by all threads since the last
+     * reset.
+     */
+    std::size_t getUsed() const;
+
+private:
+
+    std::unordered_map< std::thread::id, std::unique_ptr<LinearArena> > m_Arenas;
+    mutable std::mutex  m_Mutex;
+    std::uint64_t       m_InstanceID;
+};
+
+/*!
+ * @brief Adapts a LinearArena to the standard allocator interface.
+ *
+ * Allows standard containers to use per-frame memory:
+ * @code
+ * std::vector<Entity::ID, ArenaAllocator<Entity::ID>> visible(
+ *     world->getFrameAllocator().local());
+ * @endcode
+ * Deallocation does nothing, memory is returned when the arena is reset.
+ * The container must therefore not outlive the frame.
+ */
+template <class T>
+class ArenaAllocator
+{
+public:
+
+    typedef T value_type;
+
+    ArenaAllocator(LinearArena& arena) : m_Arena(&arena) {}
+
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : m_Arena(other.getArena()) {}
+
+    T* allocate(std::size_t count)
+    {
+        return m_Arena->allocate<T>(count);
+    }
+
+    void deallocate(T*, std::size_t) {}
+
+    LinearArena* getArena() const
+    {
+        return m_Arena;
+    }
+
+private:
+
+    LinearArena* m_Arena;
+};
+
+// ----------------------------------------------------------------------------
+template <class T, class U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+{
+    return a.getArena() == b.getArena();
+}
+
+// ----------------------------------------------------------------------------
+template <class T, class U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+{
+    return !(a == b);
+}
+
+// ----------------------------------------------------------------------------
+template <class T>
+T* LinearArena::allocate(std::size_t count)
+{
+    return static_cast<T*>(this->allocate(sizeof(T) * count, alignof(T)));
+}
+
+} // namespace Ontology
+
+#endif // __ONTOLOGY_FRAME_ALLOCATOR_HPP__
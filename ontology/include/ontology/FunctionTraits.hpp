@@ -0,0 +1,108 @@
+// ----------------------------------------------------------------------------
+// FunctionTraits.hpp
+// ----------------------------------------------------------------------------
+
+#ifndef __ONTOLOGY_FUNCTION_TRAITS_HPP__
+#define __ONTOLOGY_FUNCTION_TRAITS_HPP__
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <cstddef>
+#include <type_traits>
+
+namespace Ontology {
+
+/*!
+ * @brief A compile-time list of types.
+ */
+template <class... T>
+struct TypeList
+{
+};
+
+/*!
+ * @brief A compile-time sequence of indices, for unpacking tuples.
+ */
+template <std::size_t... I>
+struct IndexSequence
+{
+};
+
+/*!
+ * @brief Generates IndexSequence<0, 1, ..., N-1> as member type "type".
+ */
+template <std::size_t N, std::size_t... I>
+struct MakeIndexSequence :
+    public MakeIndexSequence<N - 1, N - 1, I...>
+{
+};
+
+template <std::size_t... I>
+struct MakeIndexSequence<0, I...>
+{
+    typedef IndexSequence<I...> type;
+};
+
+/*!
+ * @brief Deduces the return type and parameter types of a callable.
+ *
+ * Works with function pointers, member function pointers and classes with a
+ * non-overloaded operator(), which includes lambdas.
+ * @code
+ * auto f = [](Position& p, const Velocity& v) {};
+ * typedef FunctionTraits<decltype(f)>::Arguments Args; // TypeList<Position&, const Velocity&>
+ * @endcode
+ */
+template <class F>
+struct FunctionTraits :
+    public FunctionTraits<decltype(&F::operator())>
+{
+};
+
+template <class R, class... Args>
+struct FunctionTraits<R (*)(Args...)>
+{
+    typedef R ReturnType;
+    typedef TypeList<Args...> Arguments;
+};
+
+template <class C, class R, class... Args>
+struct FunctionTraits<R (C::*)(Args...)> :
+    public FunctionTraits<R (*)(Args...)>
+{
+};
+
+template <class C, class R, class... Args>
+struct FunctionTraits<R (C::*)(Args...) const> :
+    public FunctionTraits<R (*)(Args...)>
+{
+};
+
+/*!
+ * @brief Strips references and cv-qualifiers from a parameter type.
+ *
+ * For a parameter "const Velocity&" this is "Velocity".
+ */
+template <class T>
+struct ParameterType
+{
+    typedef typename std::remove_cv<typename std::remove_reference<T>::type>::type type;
+};
+
+/*!
+ * @brief True if a parameter of this type can modify its argument.
+ *
+ * Only non-const lvalue references can. Parameters taken by value or by const
+ * reference only read.
+ */
+template <class T>
+struct IsWriteParameter : public std::integral_constant<bool,
+    std::is_lvalue_reference<T>::value &&
+    !std::is_const<typename std::remove_reference<T>::type>::value>
+{
+};
+
+} // namespace Ontology
+
+#endif // __ONTOLOGY_FUNCTION_TRAITS_HPP__
@@ -0,0 +1,209 @@
+// ----------------------------------------------------------------------------
+// Hierarchy.hpp
+// ----------------------------------------------------------------------------
+
+#ifndef __ONTOLOGY_HIERARCHY_HPP__
+#define __ONTOLOGY_HIERARCHY_HPP__
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <ontology/Config.hpp>
+#include <ontology/Entity.hxx>
+#include <ontology/EntityManagerListener.hpp>
+#include <ontology/ThreadPool.hpp>
+
+#include <cstddef>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+// forward declarations
+
+namespace Ontology {
+    class World;
+}
+
+namespace Ontology {
+
+/*!
+ * @brief Parent/child relations between the entities of a world.
+ *
+ * Every world owns a hierarchy, accessed with World::getHierarchy():
+ * @code
+ * world.getHierarchy().setParent(wheel.getID(), car.getID());
+ * @endcode
+ * Nodes are stored in breadth-first order, sorted by depth: all roots come
+ * first, then all of their children, and so on. Every node knows the index of
+ * its parent, which always precedes it. This turns transform propagation into
+ * a single linear sweep instead of chasing pointers through a tree:
+ * @code
+ * // world transforms, stored in the order of the hierarchy's nodes
+ * std::vector<Matrix> global(hierarchy.getNodes().size());
+ * hierarchy.propagate([&](std::size_t index, std::size_t parentIndex) {
+ *     global[index] = global[parentIndex] * local(hierarchy.getNodes()[index].entity);
+ * }, &world.getThreadPool());
+ * @endcode
+ * The order is rebuilt lazily after the hierarchy changed, the first time it
+ * is accessed.
+ *
+ * Destroying an entity removes it from the hierarchy, its children become
+ * roots.
+ */
+class ONTOLOGY_PUBLIC_API Hierarchy : public EntityManagerListener
+{
+public:
+
+    /// Marks a missing parent, child or sibling.
+    static const Entity::ID InvalidID;
+
+    /// Marks a missing parent index.
+    static const std::size_t InvalidIndex;
+
+    struct Node
+    {
+        Entity::ID  entity;
+        Entity::ID  parent;
+        Entity::ID  firstChild;
+        Entity::ID  nextSibling;
+        /// The position of the parent in Hierarchy::getNodes().
+        std::size_t parentIndex;
+        /// 0 for roots, 1 for their children, and so on.
+        std::size_t depth;
+    };
+
+    /*!
+     * @brief Constructs an empty hierarchy.
+     * @param world The world to log errors to, may be null.
+     */
+    Hierarchy(World* world=nullptr);
+
+    /*!
+     * @brief Attaches an entity to a parent.
+     *
+     * Both entities are added to the hierarchy if they aren't part of it yet.
+     * If the child already has a parent, it is detached from it first.
+     * @note A parent must not be a descendant of its child. Such requests
+     * are logged and ignored.
+     */
+    void setParent(Entity::ID child, Entity::ID parent);
+
+    /*!
+     * @brief Detaches an entity from its parent, making it a root.
+     */
+    void removeParent(Entity::ID child);
+
+    /*!
+     * @brief Removes an entity from the hierarchy. Its children become roots.
+     */
+    void remove(Entity::ID entity);
+
+    /*!
+     * @brief Checks if the entity is part of the hierarchy.
+     */
+    bool contains(Entity::ID entity) const;
+
+    /*!
+     * @brief Gets the parent of an entity.
+     * @return The parent, or Hierarchy::InvalidID for roots.
+     */
+    Entity::ID getParent(Entity::ID entity) const;
+
+    /*!
+     * @brief Gets the children of an entity.
+     */
+    std::vector<Entity::ID> getChildren(Entity::ID entity) const;
+
+    /*!
+     * @brief Gets the position of the entity in Hierarchy::getNodes().
+     */
+    std::size_t getIndex(Entity::ID entity) const;
+
+    /*!
+     * @brief Gets all nodes in breadth-first order.
+     */
+    const std::vector<Node>& getNodes() const;
+
+    /*!
+     * @brief Gets the number of levels, the depth of the deepest node plus one.
+     */
+    std::size_t getLevelCount() const;
+
+    /*!
+     * @brief Gets the index of the first node of the specified depth.
+     *
+     * The nodes of depth d are found in [getLevelBegin(d), getLevelBegin(d+1)).
+     */
+    std::size_t getLevelBegin(std::size_t depth) const;
+
+    /*!
+     * @brief Calls a function for every node that has a parent, parents first.
+     *
+     * The function receives the index of the node and the index of its
+     * parent. Levels are processed one after another. If a thread pool is
+     * given, the nodes of a level are processed in parallel, as none of them
+     * depend on each other.
+     * @param function Called as function(std::size_t index, std::size_t parentIndex).
+     * @param threadPool The thread pool to process levels with, or nullptr.
+     * @param grainSize The number of nodes per parallel chunk.
+     */
+    template <class F>
+    void propagate(F function, ThreadPool* threadPool=nullptr, std::size_t grainSize=1024) const;
+
+    void onDestroyEntity(Entity& entity) override;
+
+private:
+
+    /*!
+     * @brief Adds a root node if the entity isn't part of the hierarchy yet.
+     * @return The node of the entity.
+     */
+    Node& findOrAdd(Entity::ID entity);
+
+    /*!
+     * @brief Removes a node from its parent's list of children.
+     */
+    void unlink(Node& node);
+
+    /*!
+     * @brief Rebuilds the breadth-first order if the hierarchy changed.
+     */
+    void sort() const;
+
+    World*                                                  m_World;
+    mutable std::vector<Node>                               m_Nodes;
+    mutable std::unordered_map<Entity::ID, std::size_t>     m_Index;
+    mutable std::vector<std::size_t>                        m_LevelBegin;
+    mutable bool                                            m_Dirty;
+};
+
+// ----------------------------------------------------------------------------
+template <class F>
+void Hierarchy::propagate(F function, ThreadPool* threadPool, std::size_t grainSize) const
+{
+    this->sort();
+
+    // roots have nothing to inherit
+    for(std::size_t depth = 1; depth < this->getLevelCount(); ++depth)
+    {
+        const std::size_t begin = m_LevelBegin[depth];
+        const std::size_t end = m_LevelBegin[depth + 1];
+        if(threadPool && end - begin > grainSize)
+        {
+            threadPool->parallelFor(end - begin, grainSize, [this, begin, &function](std::size_t first, std::size_t last) {
+                for(std::size_t index = begin + first; index != begin + last; ++index)
+                    function(index, m_Nodes[index].parentIndex);
+            });
+        }
+        else
+        {
+            for(std::size_t index = begin; index != end; ++index)
+                function(index, m_Nodes[index].parentIndex);
+        }
+    }
+}
+
+} // namespace Ontology
+
+#endif // __ONTOLOGY_HIERARCHY_HPP__
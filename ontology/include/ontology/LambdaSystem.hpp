@@ -0,0 +1,178 @@
+// ----------------------------------------------------------------------------
+// LambdaSystem.hpp
+// ----------------------------------------------------------------------------
+
+#ifndef __ONTOLOGY_LAMBDA_SYSTEM_HPP__
+#define __ONTOLOGY_LAMBDA_SYSTEM_HPP__
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <ontology/FunctionTraits.hpp>
+#include <ontology/System.hpp>
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Ontology {
+
+/*!
+ * @brief The pointer a LambdaSystem caches for a parameter of type P.
+ *
+ * Parameters that only read point to const components, so they may refer to
+ * shared components.
+ */
+template <class P>
+struct ComponentPointer
+{
+    typedef typename ParameterType<P>::type Component;
+    typedef typename std::conditional<IsWriteParameter<P>::value, Component*, const Component*>::type type;
+};
+
+// ----------------------------------------------------------------------------
+// Entity is incomplete where this header is included. Deferring the calls
+// through a template parameter delays the lookup until instantiation.
+template <class T, class E>
+inline T* getWrittenComponentOf(E& entity)
+{
+    return &entity.template getComponent<T>();
+}
+
+// ----------------------------------------------------------------------------
+template <class T, class E>
+inline const T* getReadComponentOf(E& entity, std::true_type)
+{
+    return &entity.template getComponent<T>();
+}
+
+// ----------------------------------------------------------------------------
+template <class T, class E>
+inline const T* getReadComponentOf(E& entity, std::false_type)
+{
+    return &entity.template getSharedComponent<T>();
+}
+
+// ----------------------------------------------------------------------------
+template <class T, class E>
+inline T* getComponentOf(E& entity, std::true_type)
+{
+    return getWrittenComponentOf<T>(entity);
+}
+
+// ----------------------------------------------------------------------------
+template <class T, class E>
+inline const T* getComponentOf(E& entity, std::false_type)
+{
+    // tags are never shared, and getSharedComponent() refuses them
+    return getReadComponentOf<T>(entity, IsTagComponent<T>());
+}
+
+// ----------------------------------------------------------------------------
+template <class P, class E>
+inline typename ComponentPointer<P>::type getComponentOf(E& entity)
+{
+    return getComponentOf<typename ParameterType<P>::type>(entity, IsWriteParameter<P>());
+}
+
+/*!
+ * @brief A system whose processing is done by a callable.
+ *
+ * The supported components and the access declarations are deduced from the
+ * parameters of the callable. Parameters taken by non-const reference are
+ * declared as written, all others as read. Read parameters may refer to
+ * shared components (see Entity::addSharedComponent()). Entities are handed to the
+ * callable directly from the iteration loop, without a virtual call per
+ * entity. The components of every entity are looked up once whenever the
+ * entity list changes and cached alongside it, so processing doesn't search
+ * the component maps of the entities.
+ *
+ * Lambda systems are created with SystemManager::addSystem(const char*, F).
+ */
+template <class F, class... Args>
+class LambdaSystem : public System
+{
+public:
+
+    /*!
+     * @brief Construct from the callable processing each entity.
+     */
+    LambdaSystem(F function) :
+        m_Function(std::move(function))
+    {
+        this->supportsComponents<typename ParameterType<Args>::type...>();
+
+        TypeSet readTypes, writeTypes;
+        int expand[] = {0, (
+            (IsWriteParameter<Args>::value ? writeTypes : readTypes)
+                .insert(&typeid(typename ParameterType<Args>::type)), 0)...};
+        (void)expand;
+        this->declareAccess(readTypes, writeTypes);
+    }
+
+    void initialise() override {}
+    void processEntity(Entity& entity) override
+    {
+        m_Function(*getComponentOf<Args>(entity)...);
+    }
+    void configureEntity(Entity&, std::string) override {}
+
+protected:
+
+    void processEntities(EntityList::iterator first, EntityList::iterator last) override
+    {
+        this->processCached(
+            static_cast<std::size_t>(first - m_CachedList),
+            static_cast<std::size_t>(last - m_CachedList),
+            typename MakeIndexSequence<sizeof...(Args)>::type()
+        );
+    }
+
+    void onEntityListChanged(EntityList& entityList) override
+    {
+        m_CachedList = entityList.begin();
+        m_ComponentCache.clear();
+        for(auto& entity : entityList)
+            m_ComponentCache.emplace_back(getComponentOf<Args>(entity.get())...);
+    }
+
+private:
+
+    typedef std::tuple<typename ComponentPointer<Args>::type...> ComponentPointers;
+
+    template <std::size_t... I>
+    void processCached(std::size_t first, std::size_t last, IndexSequence<I...>)
+    {
+        for(std::size_t i = first; i != last; ++i)
+        {
+            const ComponentPointers& components = m_ComponentCache[i];
+            (void)components;
+            m_Function(*std::get<I>(components)...);
+        }
+    }
+
+    F m_Function;
+    EntityList::iterator m_CachedList;
+    std::vector<ComponentPointers> m_ComponentCache;
+};
+
+// ----------------------------------------------------------------------------
+template <class F, class List>
+struct LambdaSystemFromList;
+
+template <class F, class... Args>
+struct LambdaSystemFromList< F, TypeList<Args...> >
+{
+    typedef LambdaSystem<F, Args...> type;
+};
+
+/*!
+ * @brief The LambdaSystem type processing entities with the callable F.
+ */
+template <class F>
+using LambdaSystemType = typename LambdaSystemFromList<F, typename FunctionTraits<F>::Arguments>::type;
+
+} // namespace Ontology
+
+#endif // __ONTOLOGY_LAMBDA_SYSTEM_HPP__
@@ -2,9 +2,15 @@
 #define __ONTOLOGY_HPP__
 
 #include <ontology/World.hpp>
+#include <ontology/CommandBuffer.hpp>
+#include <ontology/FrameAllocator.hpp>
+#include <ontology/Hierarchy.hpp>
+#include <ontology/Reduction.hpp>
+#include <ontology/StaticWorld.hpp>
 #include <ontology/SystemManager.hpp>
 #include <ontology/EntityManager.hpp>
 #include <ontology/Entity.hpp>
+#include <ontology/EntityListener.hpp>
 #include <ontology/Component.hpp>
 
 #endif // __ONTOLOGY_HPP__
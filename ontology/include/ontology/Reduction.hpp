@@ -0,0 +1,166 @@
+// ----------------------------------------------------------------------------
+// Reduction.hpp
+// ----------------------------------------------------------------------------
+
+#ifndef __ONTOLOGY_REDUCTION_HPP__
+#define __ONTOLOGY_REDUCTION_HPP__
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <ontology/Config.hpp>
+#include <ontology/System.hpp>
+
+#include <functional>
+#include <vector>
+
+namespace Ontology {
+
+/*!
+ * @brief Interface the System uses to reset and merge its reductions.
+ */
+class ONTOLOGY_PUBLIC_API ReductionBase
+{
+public:
+
+    virtual ~ReductionBase() {}
+
+    /*!
+     * @brief Discards all accumulated values and prepares one accumulator
+     * per chunk.
+     */
+    virtual void reset(std::size_t chunkCount) = 0;
+
+    /*!
+     * @brief Combines the accumulators of all chunks into the result.
+     */
+    virtual void merge() = 0;
+};
+
+/*!
+ * @brief Aggregates a value across all entities processed by a system.
+ *
+ * Every chunk of entities accumulates into its own value, so processEntity()
+ * doesn't need atomics or locks even when entities are processed in parallel.
+ * The values are combined in chunk order once per update, after all entities
+ * were processed.
+ * @code
+ * class StatsSystem : public Ontology::System
+ * {
+ *     void processEntity(Ontology::Entity& entity) override
+ *     {
+ *         m_Mass.local() += entity.getComponent<Body>().mass;
+ *     }
+ *     Ontology::Reduction<float> m_Mass{*this};
+ * };
+ * @endcode
+ * After the update, Reduction::get() returns the combined value. Systems
+ * with an entity or time budget only process a slice of their entities per
+ * update, so their reductions accumulate until the slices wrapped around the
+ * entity list. Until then, get() keeps returning the value of the last
+ * complete pass.
+ * @note The reduction must not outlive the system it was constructed with.
+ */
+template <class T>
+class Reduction : public ReductionBase
+{
+public:
+
+    typedef std::function<T(const T&, const T&)> Combine;
+
+    /*!
+     * @brief Registers the reduction with a system.
+     * @param system The system whose updates reset and merge the reduction.
+     * @param identity The value every accumulator starts with.
+     * @param combine Combines two values. Defaults to addition.
+     */
+    Reduction(System& system, T identity=T(), Combine combine=std::plus<T>());
+    ~Reduction();
+
+    Reduction(const Reduction&) = delete;
+    Reduction& operator=(const Reduction&) = delete;
+
+    /*!
+     * @brief Gets the accumulator of the chunk the calling thread is processing.
+     */
+    T& local();
+
+    /*!
+     * @brief Gets the combined value of the last complete pass over the
+     * system's entities.
+     */
+    const T& get() const;
+
+    void reset(std::size_t chunkCount) override;
+    void merge() override;
+
+private:
+
+    // align accumulators to their own cache line so chunks processed on
+    // different threads don't invalidate each other's lines
+    struct alignas(64) Accumulator
+    {
+        T value;
+    };
+
+    System&                   m_System;
+    T                         m_Identity;
+    Combine                   m_Combine;
+    std::vector<Accumulator>  m_Accumulators;
+    T                         m_Result;
+};
+
+// ----------------------------------------------------------------------------
+template <class T>
+Reduction<T>::Reduction(System& system, T identity, Combine combine) :
+    m_System(system),
+    m_Identity(identity),
+    m_Combine(combine),
+    m_Result(identity)
+{
+    this->reset(1);
+    m_System.addReduction(this);
+}
+
+// ----------------------------------------------------------------------------
+template <class T>
+Reduction<T>::~Reduction()
+{
+    m_System.removeReduction(this);
+}
+
+// ----------------------------------------------------------------------------
+template <class T>
+T& Reduction<T>::local()
+{
+    return m_Accumulators[m_System.getCurrentChunk()].value;
+}
+
+// ----------------------------------------------------------------------------
+template <class T>
+const T& Reduction<T>::get() const
+{
+    return m_Result;
+}
+
+// ----------------------------------------------------------------------------
+template <class T>
+void Reduction<T>::reset(std::size_t chunkCount)
+{
+    m_Accumulators.resize(chunkCount);
+    for(auto& accumulator : m_Accumulators)
+        accumulator.value = m_Identity;
+}
+
+// ----------------------------------------------------------------------------
+template <class T>
+void Reduction<T>::merge()
+{
+    m_Result = m_Identity;
+    for(const auto& accumulator : m_Accumulators)
+        m_Result = m_Combine(m_Result, accumulator.value);
+}
+
+} // namespace Ontology
+
+#endif // __ONTOLOGY_REDUCTION_HPP__
@@ -0,0 +1,179 @@
+// ----------------------------------------------------------------------------
+// SharedComponentPool.hpp
+// ----------------------------------------------------------------------------
+
+#ifndef __ONTOLOGY_SHARED_COMPONENT_POOL_HPP__
+#define __ONTOLOGY_SHARED_COMPONENT_POOL_HPP__
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <ontology/Component.hpp>
+#include <ontology/TypeContainers.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Ontology {
+
+/*!
+ * @brief Hashes shared component values, if the type supports it.
+ *
+ * Types with a std::hash specialisation are hashed with it. All other types
+ * hash to 0, which makes the pool compare against every live value.
+ */
+template <class T>
+class SharedComponentHash
+{
+    template <class U>
+    static std::true_type test(decltype(std::hash<U>()(std::declval<const U&>()))*);
+    template <class U>
+    static std::false_type test(...);
+
+    static std::size_t hash(const T& value, std::true_type) { return std::hash<T>()(value); }
+    static std::size_t hash(const T&, std::false_type) { return 0; }
+
+public:
+
+    std::size_t operator()(const T& value) const
+    {
+        return hash(value, decltype(test<T>(nullptr))());
+    }
+};
+
+/*!
+ * @brief Deduplicates component values shared by many entities.
+ *
+ * Many entities often carry identical read-only data, such as a mesh handle
+ * or material parameters. Instead of allocating one copy per entity, the pool
+ * hands out the same instance to every entity adding an equal value. The pool
+ * only holds weak references, so a value is destroyed and removed from the
+ * pool as soon as the last entity referencing it removes it.
+ *
+ * Shared component types must be copy or move constructible and comparable
+ * with operator==. Values are bucketed by their hash, so only values with an
+ * equal hash are compared. Specialise std::hash for the type to make finding
+ * a value independent of the number of distinct values, otherwise every live
+ * value of the type is compared.
+ *
+ * Use Entity::addSharedComponent() rather than this class directly.
+ * @see Entity::addSharedComponent
+ */
+class SharedComponentPool
+{
+public:
+
+    SharedComponentPool() : m_Values(std::make_shared< TypeMap<ValueBuckets> >()) {}
+
+    /*!
+     * @brief Gets the instance equal to a value constructed from the arguments.
+     *
+     * If no live instance compares equal, the new value is moved into the pool.
+     */
+    template <class T, class... Args>
+    std::shared_ptr<Component> acquire(Args&&... args)
+    {
+        T value(std::forward<Args>(args)...);
+
+        const std::size_t hash = SharedComponentHash<T>()(value);
+        auto& values = (*m_Values)[&typeid(T)][hash];
+        for(const auto& entry : values)
+        {
+            std::shared_ptr<Component> existing = entry.reference.lock();
+            if(existing && *static_cast<const T*>(existing.get()) == value)
+                return existing;
+        }
+
+        // the last entity releasing the value removes it from the pool again.
+        // The pool may be destroyed before the entities holding its values.
+        std::weak_ptr< TypeMap<ValueBuckets> > pool = m_Values;
+        std::shared_ptr<Component> created(new T(std::move(value)), [pool, hash](T* value) {
+            if(std::shared_ptr< TypeMap<ValueBuckets> > values = pool.lock())
+                SharedComponentPool::erase(*values, &typeid(T), hash, value);
+            delete value;
+        });
+        values.push_back(Entry(created));
+        return created;
+    }
+
+    /*!
+     * @brief Gets the number of distinct live values of the specified type.
+     */
+    template <class T>
+    std::size_t count() const
+    {
+        const auto it = m_Values->find(&typeid(T));
+        if(it == m_Values->end())
+            return 0;
+
+        std::size_t liveValues = 0;
+        for(const auto& bucket : it->second)
+            liveValues += bucket.second.size();
+        return liveValues;
+    }
+
+    /*!
+     * @brief Gets the number of distinct hashes of live values of the
+     * specified type.
+     */
+    template <class T>
+    std::size_t bucketCount() const
+    {
+        const auto it = m_Values->find(&typeid(T));
+        if(it == m_Values->end())
+            return 0;
+        return it->second.size();
+    }
+
+private:
+
+    struct Entry
+    {
+        explicit Entry(const std::shared_ptr<Component>& value) :
+            value(value.get()),
+            reference(value)
+        {}
+
+        // identifies the entry once the reference expired
+        const Component*            value;
+        std::weak_ptr<Component>    reference;
+    };
+
+    typedef std::unordered_map< std::size_t, std::vector<Entry> > ValueBuckets;
+
+    /*!
+     * @brief Removes a released value and its bucket, if it was the last one.
+     */
+    static void erase(TypeMap<ValueBuckets>& values, const std::type_info* type, std::size_t hash, const Component* value)
+    {
+        const auto buckets = values.find(type);
+        if(buckets == values.end())
+            return;
+        const auto bucket = buckets->second.find(hash);
+        if(bucket == buckets->second.end())
+            return;
+
+        auto& entries = bucket->second;
+        for(auto it = entries.begin(); it != entries.end(); ++it)
+            if(it->value == value)
+            {
+                entries.erase(it);
+                break;
+            }
+        if(entries.empty())
+            buckets->second.erase(bucket);
+        if(buckets->second.empty())
+            values.erase(buckets);
+    }
+
+    std::shared_ptr< TypeMap<ValueBuckets> > m_Values;
+};
+
+} // namespace Ontology
+
+#endif // __ONTOLOGY_SHARED_COMPONENT_POOL_HPP__
@@ -0,0 +1,210 @@
+// ----------------------------------------------------------------------------
+// SpatialIndex.hpp
+// ----------------------------------------------------------------------------
+
+#ifndef __ONTOLOGY_SPATIAL_INDEX_HPP__
+#define __ONTOLOGY_SPATIAL_INDEX_HPP__
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <ontology/Config.hpp>
+#include <ontology/Entity.hxx>
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+// forward declarations
+
+namespace Ontology {
+    class EntityManager;
+    class World;
+}
+
+namespace Ontology {
+
+/*!
+ * @brief A position in space, see SpatialIndex::Point.
+ */
+struct SpatialPoint
+{
+    SpatialPoint(float x=0, float y=0, float z=0) : x(x), y(y), z(z) {}
+    float x, y, z;
+};
+
+/*!
+ * @brief Finds entities by position without scanning all of them.
+ *
+ * The index is a uniform grid hashing positions into cells. It is attached to
+ * the component storing an entity's position with World::addSpatialIndex():
+ * @code
+ * world.addSpatialIndex<Position>(10.0f, [](const Position& position) {
+ *     return SpatialIndex::Point(position.x, position.y);
+ * });
+ * std::vector<Entity::ID> neighbours = world.queryRadius(SpatialIndex::Point(0, 0), 25.0f);
+ * @endcode
+ * The grid is rebuilt by the first query after the position component
+ * changed, as tracked by World::markChanged(). Systems moving entities should
+ * therefore declare System::writes() on the position component.
+ *
+ * Changes are tracked per component type, not per entity, so the grid isn't
+ * updated incrementally. Any change, even moving a single entity, rebuilds
+ * it from scratch with a pass over all entities and a sort of their cells.
+ * Worlds moving entities every frame pay for one full rebuild per frame,
+ * shared by all queries of that frame.
+ *
+ * Choose a cell size close to the typical query radius. Much smaller cells
+ * make queries visit many empty cells, much larger cells make them test many
+ * entities that are out of range.
+ *
+ * Optionally, the index also moves entities that are close to each other
+ * next to each other in memory, so neighbour queries and collision systems
+ * touch fewer cache lines:
+ * @code
+ * world.addSpatialIndex<Position>(...).setReorderBudget(4096);
+ * @endcode
+ */
+class ONTOLOGY_PUBLIC_API SpatialIndex
+{
+public:
+
+    typedef SpatialPoint Point;
+
+    /*!
+     * @brief Gets the position of an entity.
+     * @return False if the entity has no position.
+     */
+    typedef std::function<bool(const Entity&, Point&)> PositionFunction;
+
+    /*!
+     * @brief Constructs an index for positions of the specified component type.
+     * @param positionType The component whose changes cause a rebuild.
+     * @param cellSize The edge length of a grid cell.
+     * @param position Gets the position of an entity.
+     */
+    SpatialIndex(const std::type_info* positionType, float cellSize, PositionFunction position);
+
+    /*!
+     * @brief Wraps a function reading the position from a component.
+     */
+    template <class T, class E>
+    static PositionFunction makePositionFunction(std::function<Point(const T&)> position);
+
+    /*!
+     * @brief Gets all entities within a radius of a point.
+     * @note This function is thread safe.
+     */
+    std::vector<Entity::ID> queryRadius(const World& world, Point center, float radius);
+
+    /*!
+     * @brief Gets all entities within an axis aligned box.
+     * @note This function is thread safe.
+     */
+    std::vector<Entity::ID> queryAABB(const World& world, Point min, Point max);
+
+    /*!
+     * @brief Rebuilds the whole grid if the position component changed since
+     * the last build.
+     * @note This function is thread safe.
+     */
+    void refresh(const World& world);
+
+    /*!
+     * @brief Gets the number of entities in the index.
+     */
+    std::size_t size() const;
+
+    /*!
+     * @brief Enables sorting the entity list by position, a few entities per
+     * update.
+     *
+     * Every World::update() sorts one window of entities by the Morton code
+     * of their grid cell, then moves on to the next window. Consecutive
+     * sweeps shift the window boundaries by half a window, so entities
+     * migrate across them and the list converges towards a global order.
+     * Windows that are already sorted cost a pass over their keys and
+     * nothing else.
+     * @param entitiesPerUpdate The size of a window, 0 disables sorting.
+     * @return Returns itself for chaining.
+     */
+    SpatialIndex& setReorderBudget(std::size_t entitiesPerUpdate);
+
+    /*!
+     * @brief Sorts the next window of entities.
+     * @note Called by World::update(), unless the budget is 0.
+     */
+    void reorderEntities(EntityManager& entityManager);
+
+private:
+
+    struct Entry
+    {
+        std::uint64_t   cell;
+        Entity::ID      entity;
+        Point           position;
+    };
+
+    typedef std::unordered_map< std::uint64_t, std::pair<std::size_t, std::size_t> > CellMap;
+
+    /*!
+     * @brief Gets the grid coordinate of a position along one axis.
+     */
+    std::int64_t getCellCoordinate(float position) const;
+
+    /*!
+     * @brief Combines grid coordinates into the key of a cell.
+     */
+    static std::uint64_t getCellKey(std::int64_t x, std::int64_t y, std::int64_t z);
+
+    /*!
+     * @brief Interleaves the bits of an entity's grid coordinates.
+     * @return The Morton code, or the largest code for entities without
+     * position.
+     */
+    std::uint64_t getMortonCode(const Entity& entity) const;
+
+    /*!
+     * @brief Rebuilds the grid if the position component changed.
+     * @note The caller must hold the mutex.
+     */
+    void refreshLocked(const World& world);
+
+    /*!
+     * @brief Calls a function for every entry within the box.
+     */
+    void forEachInBox(Point min, Point max, const std::function<void(const Entry&)>& function) const;
+
+    const std::type_info*   m_PositionType;
+    float                   m_CellSize;
+    PositionFunction        m_Position;
+    std::vector<Entry>      m_Entries;
+    CellMap                 m_Cells;
+    std::uint64_t           m_BuildTick;
+    bool                    m_Built;
+    std::size_t             m_ReorderBudget;
+    std::size_t             m_ReorderCursor;
+    bool                    m_ReorderShifted;
+    std::mutex              m_Mutex;
+};
+
+// ----------------------------------------------------------------------------
+template <class T, class E>
+SpatialIndex::PositionFunction SpatialIndex::makePositionFunction(std::function<Point(const T&)> position)
+{
+    return [position](const E& entity, Point& point) {
+        if(!entity.template hasComponent<T>())
+            return false;
+        point = position(entity.template getComponent<T>());
+        return true;
+    };
+}
+
+} // namespace Ontology
+
+#endif // __ONTOLOGY_SPATIAL_INDEX_HPP__
@@ -0,0 +1,471 @@
+// ----------------------------------------------------------------------------
+// StaticWorld.hpp
+// ----------------------------------------------------------------------------
+
+#ifndef __ONTOLOGY_STATIC_WORLD_HPP__
+#define __ONTOLOGY_STATIC_WORLD_HPP__
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <ontology/Config.hpp>
+#include <ontology/Exception.hpp>
+#include <ontology/FunctionTraits.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Ontology {
+
+/// Lists the component types of a StaticWorld.
+template <class... T>
+struct Components
+{
+};
+
+/// Lists the system types of a StaticWorld.
+template <class... T>
+struct Systems
+{
+};
+
+/*!
+ * @brief Declares which systems of a StaticWorld must run before a system.
+ *
+ * A static system declares its dependencies with a nested typedef:
+ * @code
+ * struct MovementSystem
+ * {
+ *     typedef Ontology::After<InputSystem> Dependencies;
+ *     void process(Position& p, const Velocity& v) { ... }
+ * };
+ * @endcode
+ */
+template <class... T>
+using After = TypeList<T...>;
+
+namespace StaticWorldDetail {
+
+// ----------------------------------------------------------------------------
+// index of T in a parameter pack
+template <class T, class... List>
+struct IndexOf;
+
+template <class T, class... List>
+struct IndexOf<T, T, List...> : public std::integral_constant<std::size_t, 0>
+{
+};
+
+template <class T, class U, class... List>
+struct IndexOf<T, U, List...> :
+    public std::integral_constant<std::size_t, 1 + IndexOf<T, List...>::value>
+{
+};
+
+template <class T>
+struct IndexOf<T>
+{
+    static_assert(sizeof(T) == 0, "Type is not part of this StaticWorld");
+};
+
+// ----------------------------------------------------------------------------
+// membership test of a TypeList
+template <class T, class List>
+struct Contains;
+
+template <class T>
+struct Contains< T, TypeList<> > : public std::false_type
+{
+};
+
+template <class T, class U, class... List>
+struct Contains< T, TypeList<U, List...> > :
+    public std::integral_constant<bool,
+        std::is_same<T, U>::value || Contains< T, TypeList<List...> >::value>
+{
+};
+
+template <class Required, class List>
+struct ContainsAll;
+
+template <class List>
+struct ContainsAll< TypeList<>, List > : public std::true_type
+{
+};
+
+template <class T, class... Required, class List>
+struct ContainsAll< TypeList<T, Required...>, List > :
+    public std::integral_constant<bool,
+        Contains<T, List>::value && ContainsAll< TypeList<Required...>, List >::value>
+{
+};
+
+// ----------------------------------------------------------------------------
+// a system's dependencies, or an empty list if it declares none
+template <class T>
+struct Void
+{
+    typedef void type;
+};
+
+template <class S, class = void>
+struct DependenciesOf
+{
+    typedef TypeList<> type;
+};
+
+template <class S>
+struct DependenciesOf<S, typename Void<typename S::Dependencies>::type>
+{
+    typedef typename S::Dependencies type;
+};
+
+// ----------------------------------------------------------------------------
+// list manipulation
+template <class List, class T>
+struct Append;
+
+template <class... List, class T>
+struct Append< TypeList<List...>, T >
+{
+    typedef TypeList<List..., T> type;
+};
+
+template <class T, class List>
+struct Remove;
+
+template <class T>
+struct Remove< T, TypeList<> >
+{
+    typedef TypeList<> type;
+};
+
+template <class T, class... List>
+struct Remove< T, TypeList<T, List...> >
+{
+    typedef TypeList<List...> type;
+};
+
+template <class Head, class List>
+struct Prepend;
+
+template <class Head, class... List>
+struct Prepend< Head, TypeList<List...> >
+{
+    typedef TypeList<Head, List...> type;
+};
+
+template <class T, class U, class... List>
+struct Remove< T, TypeList<U, List...> >
+{
+    typedef typename Prepend< U, typename Remove< T, TypeList<List...> >::type >::type type;
+};
+
+// ----------------------------------------------------------------------------
+// first system in Remaining whose dependencies were all scheduled already
+template <class Scheduled, class Remaining>
+struct FirstReady;
+
+template <class Scheduled>
+struct FirstReady< Scheduled, TypeList<> >
+{
+    typedef void type;
+};
+
+template <class Scheduled, class S, class... Remaining>
+struct FirstReady< Scheduled, TypeList<S, Remaining...> >
+{
+    typedef typename std::conditional<
+        ContainsAll<typename DependenciesOf<S>::type, Scheduled>::value,
+        S,
+        typename FirstReady< Scheduled, TypeList<Remaining...> >::type
+    >::type type;
+};
+
+// ----------------------------------------------------------------------------
+// Topological sort at compile time. Systems are scheduled in the order they
+// are listed unless a dependency forces a later system to move up front.
+template <class Scheduled, class Remaining, class Next = typename FirstReady<Scheduled, Remaining>::type>
+struct ExecutionOrder
+{
+    typedef typename ExecutionOrder<
+        typename Append<Scheduled, Next>::type,
+        typename Remove<Next, Remaining>::type
+    >::type type;
+};
+
+template <class Scheduled, class Next>
+struct ExecutionOrder< Scheduled, TypeList<>, Next >
+{
+    typedef Scheduled type;
+};
+
+template <class Scheduled, class S, class... Remaining>
+struct ExecutionOrder< Scheduled, TypeList<S, Remaining...>, void >
+{
+    static_assert(sizeof(S) == 0, "Circular dependency between systems, or dependency on a system that isn't part of this StaticWorld");
+    typedef Scheduled type;
+};
+
+} // namespace StaticWorldDetail
+
+template <class ComponentList, class SystemList>
+class StaticWorld;
+
+/*!
+ * @brief A world whose component and system sets are fixed at compile time.
+ *
+ * Where the components and systems are known up front, such as on a
+ * dedicated server, StaticWorld trades the flexibility of World for speed.
+ * Every component type is stored in its own contiguous column and the system
+ * execution order is resolved by the compiler, so World::update() compiles
+ * down to a sequence of fully inlined loops without any virtual calls or
+ * type lookups.
+ *
+ * Components are plain structs. They must be default constructible and
+ * assignable. Systems are classes with a process() member function whose
+ * parameters name the components the system requires. As with lambda systems,
+ * parameters taken by non-const reference are written, all others are read.
+ * @code
+ * struct Position { float x, y; };
+ * struct Velocity { float x, y; };
+ *
+ * struct MovementSystem
+ * {
+ *     void process(Position& p, const Velocity& v) { p.x += v.x; p.y += v.y; }
+ * };
+ *
+ * typedef Ontology::StaticWorld<
+ *     Ontology::Components<Position, Velocity>,
+ *     Ontology::Systems<MovementSystem>
+ * > ServerWorld;
+ *
+ * ServerWorld world;
+ * ServerWorld::EntityID player = world.createEntity();
+ * world.addComponent<Position>(player, 0.0f, 0.0f);
+ * world.addComponent<Velocity>(player, 1.0f, 0.0f);
+ * world.update();
+ * @endcode
+ * Dependencies between systems are declared with a nested
+ * Ontology::After typedef and checked at compile time.
+ *
+ * @note The dynamic World remains available, for instance for tools.
+ */
+template <class... C, class... S>
+class StaticWorld< Components<C...>, Systems<S...> >
+{
+    static_assert(sizeof...(C) < 64, "StaticWorld supports at most 63 component types");
+
+    typedef std::uint64_t Signature;
+
+    /// Bit marking a slot as occupied by a live entity.
+    typedef std::integral_constant<Signature, Signature(1) << sizeof...(C)> AliveBit;
+
+    template <class T>
+    struct ComponentBit :
+        public std::integral_constant<Signature,
+            Signature(1) << StaticWorldDetail::IndexOf<T, C...>::value>
+    {
+    };
+
+    template <class... T>
+    struct SignatureOf : public std::integral_constant<Signature, AliveBit::value>
+    {
+    };
+
+    template <class T, class... Rest>
+    struct SignatureOf<T, Rest...> :
+        public std::integral_constant<Signature,
+            ComponentBit<typename ParameterType<T>::type>::value | SignatureOf<Rest...>::value>
+    {
+    };
+
+public:
+
+    typedef std::size_t EntityID;
+
+    /// The systems in the order they are executed, resolved at compile time.
+    typedef typename StaticWorldDetail::ExecutionOrder<
+        TypeList<>, TypeList<S...>
+    >::type ExecutionOrder;
+
+    /*!
+     * @brief Creates a new entity without any components.
+     * @return The ID of the entity. IDs of destroyed entities are reused.
+     */
+    EntityID createEntity()
+    {
+        if(!m_FreeIDs.empty())
+        {
+            const EntityID entity = m_FreeIDs.back();
+            m_FreeIDs.pop_back();
+            m_Signatures[entity] = AliveBit::value;
+            return entity;
+        }
+
+        m_Signatures.push_back(Signature(AliveBit::value));
+        this->resizeColumns(TypeList<C...>());
+        return m_Signatures.size() - 1;
+    }
+
+    /*!
+     * @brief Destroys the specified entity and all of its components.
+     *
+     * The component slots of the entity are reset to default constructed
+     * values, releasing whatever the components held. Destroying an entity
+     * that isn't alive does nothing.
+     */
+    void destroyEntity(EntityID entity)
+    {
+        if(!this->isAlive(entity))
+            return;
+        this->resetComponents(entity, TypeList<C...>());
+        m_Signatures[entity] = 0;
+        m_FreeIDs.push_back(entity);
+    }
+
+    /*!
+     * @brief Checks if the specified entity exists.
+     */
+    bool isAlive(EntityID entity) const
+    {
+        return entity < m_Signatures.size() && (m_Signatures[entity] & AliveBit::value) != 0;
+    }
+
+    /*!
+     * @brief Add a component to the specified entity.
+     * @return A reference to the new component.
+     */
+    template <class T, class... Args>
+    T& addComponent(EntityID entity, Args&&... args)
+    {
+        ONTOLOGY_ASSERT(this->isAlive(entity), InvalidEntityException, StaticWorld::addComponent,
+            std::string("Entity ") + std::to_string(entity) + " isn't alive"
+        )
+        T& component = this->getColumn<T>()[entity];
+        component = T{std::forward<Args>(args)...};
+        m_Signatures[entity] |= ComponentBit<T>::value;
+        return component;
+    }
+
+    /*!
+     * @brief Remove a component from the specified entity.
+     */
+    template <class T>
+    void removeComponent(EntityID entity)
+    {
+        m_Signatures[entity] &= ~ComponentBit<T>::value;
+    }
+
+    /*!
+     * @brief Checks if the specified entity has a component.
+     */
+    template <class T>
+    bool hasComponent(EntityID entity) const
+    {
+        return (m_Signatures[entity] & ComponentBit<T>::value) != 0;
+    }
+
+    /*!
+     * @brief Gets a component of the specified entity.
+     */
+    template <class T>
+    T& getComponent(EntityID entity)
+    {
+        ONTOLOGY_ASSERT(this->isAlive(entity), InvalidEntityException, StaticWorld::getComponent,
+            std::string("Entity ") + std::to_string(entity) + " isn't alive"
+        )
+        return this->getColumn<T>()[entity];
+    }
+
+    /*!
+     * @brief Gets the specified system.
+     */
+    template <class T>
+    T& getSystem()
+    {
+        return std::get<StaticWorldDetail::IndexOf<T, S...>::value>(m_Systems);
+    }
+
+    /*!
+     * @brief Update all systems in their compile-time execution order.
+     */
+    void update()
+    {
+        this->updateSystems(ExecutionOrder());
+    }
+
+private:
+
+    template <class T>
+    std::vector<T>& getColumn()
+    {
+        return std::get<StaticWorldDetail::IndexOf<T, C...>::value>(m_Columns);
+    }
+
+    template <class T>
+    const std::vector<T>& getColumn() const
+    {
+        return std::get<StaticWorldDetail::IndexOf<T, C...>::value>(m_Columns);
+    }
+
+    void resizeColumns(TypeList<>)
+    {
+    }
+
+    template <class T, class... Rest>
+    void resizeColumns(TypeList<T, Rest...>)
+    {
+        this->getColumn<T>().resize(m_Signatures.size());
+        this->resizeColumns(TypeList<Rest...>());
+    }
+
+    void resetComponents(EntityID, TypeList<>)
+    {
+    }
+
+    template <class T, class... Rest>
+    void resetComponents(EntityID entity, TypeList<T, Rest...>)
+    {
+        this->getColumn<T>()[entity] = T();
+        this->resetComponents(entity, TypeList<Rest...>());
+    }
+
+    void updateSystems(TypeList<>)
+    {
+    }
+
+    template <class System, class... Rest>
+    void updateSystems(TypeList<System, Rest...>)
+    {
+        this->updateSystem(
+            std::get<StaticWorldDetail::IndexOf<System, S...>::value>(m_Systems),
+            typename FunctionTraits<decltype(&System::process)>::Arguments()
+        );
+        this->updateSystems(TypeList<Rest...>());
+    }
+
+    template <class System, class... Args>
+    void updateSystem(System& system, TypeList<Args...>)
+    {
+        const Signature required = SignatureOf<Args...>::value;
+        const EntityID entityCount = m_Signatures.size();
+        for(EntityID entity = 0; entity != entityCount; ++entity)
+            if((m_Signatures[entity] & required) == required)
+                system.process(this->getColumn<typename ParameterType<Args>::type>()[entity]...);
+    }
+
+    std::tuple<std::vector<C>...>   m_Columns;
+    std::vector<Signature>          m_Signatures;
+    std::vector<EntityID>           m_FreeIDs;
+    std::tuple<S...>                m_Systems;
+};
+
+} // namespace Ontology
+
+#endif // __ONTOLOGY_STATIC_WORLD_HPP__
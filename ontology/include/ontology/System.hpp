@@ -8,8 +8,11 @@
 // ----------------------------------------------------------------------------
 // include files
 
+#include <ontology/Component.hpp>
 #include <ontology/System.hxx>
 
+#include <algorithm>
+
 namespace Ontology {
 
 // ----------------------------------------------------------------------------
@@ -24,14 +27,156 @@ template <class... T>
 inline System& System::supportsComponents()
 {
     m_SupportedComponents = TypeSetGenerator<T...>();
+    m_SupportedDataComponents.clear();
+    m_SupportedTags.clear();
+
+    // sort the components into those stored in an entity's component map and
+    // those only recorded in its tag signature
+    int expand[] = {0, (this->addSupportedComponent<T>(IsTagComponent<T>()), 0)...};
+    (void)expand;
+    return *this;
+}
+
+// ----------------------------------------------------------------------------
+template <class... T>
+inline System& System::reads()
+{
+    m_ReadTypes = TypeSetGenerator<T...>();
+    return *this;
+}
+
+// ----------------------------------------------------------------------------
+template <class... T>
+inline System& System::writes()
+{
+    m_WriteTypes = TypeSetGenerator<T...>();
     return *this;
 }
 
+// ----------------------------------------------------------------------------
+template <class T>
+inline System& System::groupsBySharedComponent()
+{
+    m_GroupKey = &System::getSharedComponentKey<T, Entity>;
+    m_Sorter.reset();
+    m_EntityListChanged = true;
+    return *this;
+}
+
+// ----------------------------------------------------------------------------
+template <class T, class F>
+inline System& System::sortsEntitiesBy(F key)
+{
+    typedef typename std::decay<decltype(key(std::declval<const T&>()))>::type Key;
+    m_Sorter.reset(new KeyedEntitySorter<Key>(
+        makeSortKey<T, Entity, Key>(std::function<Key(const T&)>(std::move(key)))));
+    m_GroupKey = nullptr;
+    return *this;
+}
+
+// ----------------------------------------------------------------------------
+template <class T, class E, class Key>
+std::function<Key(const E&)> System::makeSortKey(std::function<Key(const T&)> key)
+{
+    return [key](const E& entity) {
+        return key(entity.template getSharedComponent<T>());
+    };
+}
+
+// ----------------------------------------------------------------------------
+template <class Key>
+struct System::KeyedEntitySorter : public System::EntitySorter
+{
+    typedef std::pair<Key, std::reference_wrapper<Entity>> Element;
+
+    explicit KeyedEntitySorter(std::function<Key(const Entity&)> key) :
+        key(std::move(key))
+    {
+    }
+
+    bool sort(EntityList& entityList) override
+    {
+        // sort keys alongside the entities, so each key is computed once
+        buffer.clear();
+        for(auto& entity : entityList)
+            buffer.emplace_back(key(entity.get()), entity);
+
+        // insertion sort is linear on nearly sorted input, but quadratic on
+        // shuffled input. Give up on it once it moved too many elements.
+        const std::size_t moveBudget = buffer.size() * 4 + 64;
+        std::size_t moves = 0;
+        for(std::size_t i = 1; i < buffer.size() && moves <= moveBudget; ++i)
+        {
+            if(!(buffer[i].first < buffer[i - 1].first))
+                continue;
+            Element element = std::move(buffer[i]);
+            std::size_t j = i;
+            for(; j > 0 && element.first < buffer[j - 1].first; --j)
+                buffer[j] = std::move(buffer[j - 1]);
+            buffer[j] = std::move(element);
+            moves += i - j;
+        }
+        if(moves > moveBudget)
+        {
+            std::stable_sort(buffer.begin(), buffer.end(),
+                [](const Element& a, const Element& b) {
+                    return a.first < b.first;
+                }
+            );
+        }
+
+        bool changed = false;
+        for(std::size_t i = 0; i != buffer.size(); ++i)
+        {
+            if(&entityList[i].get() != &buffer[i].second.get())
+                changed = true;
+            entityList[i] = buffer[i].second;
+        }
+        return changed;
+    }
+
+    std::function<Key(const Entity&)> key;
+    std::vector<Element> buffer;
+};
+
+// ----------------------------------------------------------------------------
+template <class T, class E>
+const void* System::getSharedComponentKey(const E& entity)
+{
+    // entities sharing a value reference the same instance
+    if(!entity.template hasComponent<T>())
+        return nullptr;
+    return &entity.template getSharedComponent<T>();
+}
+
+// ----------------------------------------------------------------------------
+template <class T>
+inline void System::addSupportedComponent(std::false_type)
+{
+    m_SupportedDataComponents.insert(&typeid(T));
+}
+
+// ----------------------------------------------------------------------------
+template <class T>
+inline void System::addSupportedComponent(std::true_type)
+{
+    m_SupportedTags.push_back(getTagComponentID<T>());
+}
+
 // ----------------------------------------------------------------------------
 template <class... T>
 inline System& System::executesAfter()
 {
     m_DependingSystems = TypeSetGenerator<T...>();
+    m_DependingSystemIDs = std::vector<TypeID>({SystemID::get<T>()...});
+    return *this;
+}
+
+// ----------------------------------------------------------------------------
+template <class... T>
+inline System& System::runIfChanged()
+{
+    m_ChangeFilter = TypeSetGenerator<T...>();
     return *this;
 }
 
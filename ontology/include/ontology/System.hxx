@@ -11,7 +11,14 @@
 #include <ontology/Config.hpp>
 #include <ontology/TypeContainers.hpp>
 
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #ifdef ONTOLOGY_THREAD
 #   include <boost/thread/thread.hpp>
@@ -21,7 +28,11 @@
 // forward declarations
 
 namespace Ontology {
+    class CommandBuffer;
     class Entity;
+    class EntityManager;
+    class ReductionBase;
+    class SystemGroup;
     class World;
 }
 
@@ -37,6 +48,20 @@ inline TypeSet TypeSetGenerator();
  */
 struct None {};
 
+/*!
+ * @brief Controls whether a system processes its entities in parallel.
+ * @see System::setExecutionPolicy()
+ */
+enum class ExecutionPolicy
+{
+    /// Choose from the measured cost per entity and the number of entities.
+    Automatic,
+    /// Always process all entities on the thread updating the system.
+    Serial,
+    /// Always split the entities into chunks processed by the thread pool.
+    Parallel
+};
+
 /*!
  * @brief A system acts upon entities and their components.
  *
@@ -55,10 +80,13 @@ struct None {};
  */
 class ONTOLOGY_PUBLIC_API System
 {
-private:
-    typedef std::vector< std::reference_wrapper<Entity> > EntityList;
 public:
 
+    typedef std::vector< std::reference_wrapper<Entity> > EntityList;
+
+    /// Hands out the dense IDs systems are registered and looked up with.
+    typedef TypeIDGenerator<System> SystemID;
+
     /*!
      * @brief Default constructor.
      */
@@ -71,6 +99,16 @@ public:
     
     /*!
      * @brief Called when systems should initialise. Override this.
+     *
+     * SystemManager::initialise() calls this on the calling thread unless
+     * SystemManager::setConcurrentInitialisation() is enabled. Systems added
+     * after SystemManager::initialise() always initialise on the world's
+     * thread pool, while the other systems are updating.
+     * @note On the thread pool, other systems may initialise or update at
+     * the same time. Only access the systems declared with executesAfter()
+     * and don't modify the world. Don't call ThreadPool::wait() either, it
+     * would wait for the calling task itself and never return, whereas
+     * ThreadPool::parallelFor() is safe.
      */
     virtual void initialise() = 0;
 
@@ -89,6 +127,20 @@ public:
      * @brief Checks if this system is initialised.
      */
     bool isInitialised() const;
+
+    /*!
+     * @brief Gets the name the system was registered with.
+     *
+     * Unless a name was given to SystemManager::addSystem(), this is the
+     * demangled name of the system's type.
+     */
+    const std::string& getName() const;
+
+    /*!
+     * @brief Sets the name of the system.
+     * @note Should not be called by the user. This is an internal function.
+     */
+    ONTOLOGY_LOCAL_API void setName(std::string name);
     
     /*!
      * @brief Call this as many times as you wish, the system will only initialise once.
@@ -121,6 +173,54 @@ public:
      */
     ONTOLOGY_LOCAL_API const TypeSet& getSupportedComponents() const;
 
+    /*!
+     * @brief Keep entities referencing the same shared component value adjacent.
+     *
+     * Entities whose shared component of the specified type is the same
+     * instance (see Entity::addSharedComponent()) are passed to
+     * processEntity() one after another, so a system can process each shared
+     * value as a batch while its data is still hot in the cache.
+     * @code
+     * renderSystem.groupsBySharedComponent<Material>();
+     * @endcode
+     */
+    template <class T>
+    inline System& groupsBySharedComponent();
+
+    /*!
+     * @brief Keep entities sorted by a key computed from one of their components.
+     *
+     * Before every pass over the entities, the keys of all entities are
+     * recomputed and the entity list is re-sorted by insertion sort. Keys
+     * usually change little from one frame to the next, so this costs close
+     * to a single pass over the entities. If the order changed a lot, for
+     * instance after many entities were added, a full sort is done instead.
+     * @code
+     * sweepAndPruneSystem.sortsEntitiesBy<Position>([](const Position& position) {
+     *     return position.x;
+     * });
+     * @endcode
+     * The key can be of any type comparable with operator<. Entities with
+     * equal keys keep their relative order. Systems with an entity or time
+     * budget only re-sort once their slices wrapped around the entity list,
+     * so a pass never skips or repeats an entity.
+     * @note The component must be one of the supported components, it may be
+     * shared. Sorting replaces System::groupsBySharedComponent().
+     */
+    template <class T, class F>
+    inline System& sortsEntitiesBy(F key);
+
+    /*!
+     * @brief Gets the typeset of supported components that aren't tags.
+     */
+    ONTOLOGY_LOCAL_API const TypeSet& getSupportedDataComponents() const;
+
+    /*!
+     * @brief Gets the IDs of supported tag components.
+     * @see IsTagComponent
+     */
+    ONTOLOGY_LOCAL_API const std::vector<TypeID>& getSupportedTags() const;
+
     /*!
      * @brief Declare which systems are required to be executed before this one.
      * 
@@ -147,6 +247,190 @@ public:
      */
     ONTOLOGY_LOCAL_API const TypeSet& getDependingSystems() const;
 
+    /*!
+     * @brief Gets the SystemIDs of depending systems.
+     */
+    ONTOLOGY_LOCAL_API const std::vector<TypeID>& getDependingSystemIDs() const;
+
+    /*!
+     * @brief Moves this system into a group updating at its own rate.
+     *
+     * By default, systems are updated once per World::update().
+     * @code
+     * SystemGroup& ai = world.getSystemManager().addGroup("AI")
+     *     .setTickDivisor(6);
+     * pathfindingSystem.inGroup(ai);
+     * @endcode
+     * @see SystemGroup
+     */
+    System& inGroup(SystemGroup& group);
+
+    /*!
+     * @brief Gets the group this system is updated by, or nullptr.
+     */
+    SystemGroup* getGroup() const;
+
+    /*!
+     * @brief Controls whether entities are processed in parallel.
+     *
+     * By default, entities are processed serially, as processEntity() is
+     * only safe to call concurrently if it doesn't write shared state.
+     * Systems that are safe can opt in. With ExecutionPolicy::Automatic, the
+     * system measures how long processing an entity takes. Systems whose
+     * entities take little time in total stay serial, as handing them to
+     * other threads would cost more than it saves. Otherwise the entities
+     * are split into chunks large enough to be worth a thread and processed
+     * by the world's thread pool.
+     * @code
+     * // processEntity() only touches the entity it receives
+     * particleSystem.setExecutionPolicy(ExecutionPolicy::Automatic);
+     * @endcode
+     * @param policy The execution policy.
+     * @param grainSize The number of entities per chunk when processing in
+     * parallel. 0 chooses a grain size automatically.
+     * @note Unless the policy is ExecutionPolicy::Serial, processEntity() may
+     * be called for different entities at the same time.
+     */
+    System& setExecutionPolicy(ExecutionPolicy policy, std::size_t grainSize=0);
+
+    /*!
+     * @brief Gets the measured average time it takes to process one entity.
+     * @return The time in nanoseconds, or 0 if nothing was measured yet.
+     */
+    double getCostPerEntity() const;
+
+    /*!
+     * @brief Gets the command buffer to record changes to the world into.
+     *
+     * While processing entities, this is the buffer of the chunk the calling
+     * thread is processing. The buffers are applied in chunk order at the end
+     * of the system's update.
+     * @see CommandBuffer
+     */
+    CommandBuffer& getCommandBuffer();
+
+    /*!
+     * @brief Gets the index of the chunk of entities the calling thread is
+     * processing for this system.
+     *
+     * Chunks are numbered in the order of the entity list, starting at 0.
+     * Outside of processing, this returns 0.
+     */
+    std::size_t getCurrentChunk() const;
+
+    /*!
+     * @brief Registers a reduction to be reset and merged with every update.
+     * @note Called by the constructor of Reduction.
+     */
+    void addReduction(ReductionBase* reduction);
+
+    /*!
+     * @brief Unregisters a reduction.
+     * @note Called by the destructor of Reduction.
+     */
+    void removeReduction(ReductionBase* reduction);
+
+    /*!
+     * @brief Only runs the system if the predicate returns true.
+     *
+     * The predicate is evaluated by the SystemManager before the system is
+     * updated, for instance to check a singleton:
+     * @code
+     * debugDrawSystem.runIf([](World& world) {
+     *     return world.singleton<Settings>().debugDraw;
+     * });
+     * @endcode
+     */
+    System& runIf(std::function<bool(World&)> predicate);
+
+    /*!
+     * @brief Skips the system while it has no entities to process.
+     */
+    System& skipsWhenEmpty(bool skip=true);
+
+    /*!
+     * @brief Only runs the system if components or singletons of one of the
+     * specified types changed since the system last ran.
+     * @code
+     * navMeshSystem.runIfChanged<Obstacle>();
+     * @endcode
+     * With an entity or time budget, the system keeps running until its
+     * slices reached the end of the entity list, so every entity sees the
+     * change.
+     * @see World::markChanged()
+     */
+    template <class... T>
+    inline System& runIfChanged();
+
+    /*!
+     * @brief Evaluates the run criteria of this system.
+     * @return True if the system should be updated.
+     */
+    ONTOLOGY_LOCAL_API bool shouldRun() const;
+
+    /*!
+     * @brief Limits how many entities are processed per update.
+     *
+     * Each update processes the next slice of entities, resuming where the
+     * previous update left off and wrapping around at the end. This keeps
+     * the cost of expensive systems, such as pathfinding, flat across frames.
+     * @code
+     * pathfindingSystem.setEntityBudget(50);
+     * @endcode
+     * @param count The number of entities per update. 0 disables the budget.
+     */
+    System& setEntityBudget(std::size_t count);
+
+    /*!
+     * @brief Limits how much time is spent processing entities per update.
+     *
+     * Works like System::setEntityBudget(), except the slice ends once the
+     * budget is used up. The clock is checked after every entity, so the
+     * budget can be exceeded by the cost of one entity.
+     * @code
+     * visibilitySystem.setTimeBudget(std::chrono::microseconds(500));
+     * @endcode
+     * @param budget The time per update. 0 disables the budget.
+     * @note Both budgets can be combined, whichever runs out first ends the
+     * slice. No update processes an entity twice.
+     */
+    System& setTimeBudget(std::chrono::microseconds budget);
+
+    /*!
+     * @brief Declare which components and singletons this system only reads.
+     *
+     * Access declarations don't change which entities a system receives. They
+     * tell the scheduler which systems can safely run alongside each other.
+     * @code
+     * movementSystem.reads<
+     *     Velocity,
+     *     Time>();
+     * @endcode
+     */
+    template <class... T>
+    inline System& reads();
+
+    /*!
+     * @brief Declare which components and singletons this system modifies.
+     *
+     * The written types are marked as changed after every update that
+     * processed entities. Systems writing singletons without having any
+     * entities have to call World::markChanged() themselves.
+     * @see System::reads()
+     */
+    template <class... T>
+    inline System& writes();
+
+    /*!
+     * @brief Gets the typeset of components and singletons this system reads.
+     */
+    const TypeSet& getReadTypes() const;
+
+    /*!
+     * @brief Gets the typeset of components and singletons this system writes.
+     */
+    const TypeSet& getWriteTypes() const;
+
     /*!
      * @brief Called by the SystemManager when it receives an update event from an entity.
      *
@@ -166,11 +450,39 @@ public:
 
     ONTOLOGY_LOCAL_API void informEntitiesReallocated(std::vector<Entity>&);
 
+    /*!
+     * @brief Replaces the list of supported entities with every supported
+     * entity of the entity manager.
+     *
+     * Called by the SystemManager for systems added at runtime, which didn't
+     * see the entities created before them.
+     */
+    ONTOLOGY_LOCAL_API void collectEntities(EntityManager& entityManager);
+
+    /*!
+     * @brief Called by the SystemManager when entities moved without
+     * re-allocating.
+     *
+     * Only references to moved entities are updated, the order in which the
+     * system processes its entities is kept.
+     */
+    ONTOLOGY_LOCAL_API void informEntitiesMoved(std::vector<Entity>& entityList, std::size_t first, const std::vector<std::size_t>& destinations);
+
     /*!
      * @brief Informs the system of the world it is part of.
      */
     ONTOLOGY_LOCAL_API void setWorld(World*);
 
+    /*!
+     * @brief Informs the system of the SystemID it is registered under.
+     */
+    ONTOLOGY_LOCAL_API void setTypeID(TypeID);
+
+    /*!
+     * @brief Gets the SystemID the system is registered under.
+     */
+    ONTOLOGY_LOCAL_API TypeID getTypeID() const;
+
     /*!
      * @brief Called when the system should update all of its entities.
      */
@@ -178,6 +490,34 @@ public:
 
 protected:
 
+    /*!
+     * @brief Called when a range of entities requires processing.
+     *
+     * The default implementation calls processEntity() for every entity in
+     * the range. Systems knowing their concrete processing at compile time
+     * can override this to avoid a virtual call per entity.
+     * @note When entities are processed in parallel, this is called once per
+     * chunk, from multiple threads at the same time.
+     */
+    virtual void processEntities(EntityList::iterator first, EntityList::iterator last);
+
+    /*!
+     * @brief Called before processing if the entity list changed since the
+     * last update.
+     *
+     * Systems caching data per entity rebuild their cache here, indexed like
+     * the list processEntities() receives ranges of. A change includes
+     * components being added to or removed from listed entities.
+     */
+    virtual void onEntityListChanged(EntityList& entityList);
+
+    /*!
+     * @brief Replaces the access declarations with the specified typesets.
+     * @see System::reads()
+     * @see System::writes()
+     */
+    void declareAccess(const TypeSet& readTypes, const TypeSet& writeTypes);
+
     /*!
      * @brief Access the world the system belongs to with this.
      */
@@ -185,10 +525,112 @@ protected:
 
 private:
 
-    TypeSet         m_SupportedComponents;
-    TypeSet         m_DependingSystems;
-    EntityList      m_EntityList;
-    bool            m_Initialised;
+    typedef const void* (*GroupKeyFunction)(const Entity&);
+
+    // sorts the entity list by keys of a type only known to sortsEntitiesBy()
+    struct EntitySorter
+    {
+        virtual ~EntitySorter() {}
+
+        // returns true if the order of the entity list changed
+        virtual bool sort(EntityList& entityList) = 0;
+    };
+
+    template <class Key>
+    struct KeyedEntitySorter;
+
+    template <class T>
+    inline void addSupportedComponent(std::false_type);
+    template <class T>
+    inline void addSupportedComponent(std::true_type);
+
+    template <class T, class E>
+    static const void* getSharedComponentKey(const E& entity);
+
+    template <class T, class E, class Key>
+    static std::function<Key(const E&)> makeSortKey(std::function<Key(const T&)> key);
+
+    /*!
+     * @brief Sorts the entity list so entities sharing a group key are adjacent.
+     */
+    void groupEntities();
+
+    /*!
+     * @brief Recomputes the sort keys and restores the order of the entity list.
+     */
+    void sortEntities();
+
+    /*!
+     * @brief Processes the next slice of entities allowed by the budgets.
+     * @return True if the slice reached the end of the entity list.
+     */
+    bool processEntitySlice();
+
+    /*!
+     * @brief Processes all entities, serially or in parallel.
+     */
+    void processEntityList();
+
+    /*!
+     * @brief Processes a range of entities as the specified chunk.
+     */
+    void processChunk(std::size_t first, std::size_t last, std::size_t chunk);
+
+    /*!
+     * @brief Prepares a command buffer and reduction accumulators per chunk.
+     * @param resetReductions Whether to discard the values accumulated so far.
+     */
+    void prepareChunks(std::size_t chunkCount, bool resetReductions=true);
+
+    /*!
+     * @brief Combines the accumulators of every reduction into its result.
+     */
+    void mergeReductions();
+
+    /*!
+     * @brief Applies the recorded commands of all chunks in order.
+     */
+    void applyCommandBuffers();
+
+    /*!
+     * @brief Chooses the number of entities per parallel chunk.
+     * @return The grain size, or 0 if entities should be processed serially.
+     */
+    std::size_t chooseGrainSize(std::size_t entityCount) const;
+
+    /*!
+     * @brief Folds a measurement into the average cost per entity.
+     */
+    void recordCost(std::chrono::nanoseconds duration, std::size_t entityCount);
+
+    TypeSet             m_SupportedComponents;
+    TypeSet             m_SupportedDataComponents;
+    std::vector<TypeID> m_SupportedTags;
+    TypeSet             m_DependingSystems;
+    std::vector<TypeID> m_DependingSystemIDs;
+    TypeID              m_TypeID;
+    std::string         m_Name;
+    SystemGroup*        m_Group;
+    TypeSet             m_ReadTypes;
+    TypeSet             m_WriteTypes;
+    EntityList          m_EntityList;
+    GroupKeyFunction    m_GroupKey;
+    std::unique_ptr<EntitySorter> m_Sorter;
+    std::size_t         m_EntityBudget;
+    std::chrono::microseconds m_TimeBudget;
+    std::size_t         m_SliceCursor;
+    ExecutionPolicy     m_ExecutionPolicy;
+    std::size_t         m_GrainSize;
+    double              m_CostPerEntity;
+    std::vector< std::unique_ptr<CommandBuffer> > m_CommandBuffers;
+    std::vector<ReductionBase*> m_Reductions;
+    std::function<bool(World&)> m_RunCondition;
+    TypeSet             m_ChangeFilter;
+    std::uint64_t       m_LastRunTick;
+    bool                m_SkipWhenEmpty;
+    bool                m_EntityListChanged;
+    bool                m_EntityListStale;
+    bool                m_Initialised;
 
 #ifdef ONTOLOGY_THREAD
     void joinableThreadEntryPoint();
@@ -0,0 +1,140 @@
+// ----------------------------------------------------------------------------
+// SystemGroup.hpp
+// ----------------------------------------------------------------------------
+
+#ifndef __ONTOLOGY_SYSTEM_GROUP_HPP__
+#define __ONTOLOGY_SYSTEM_GROUP_HPP__
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <ontology/Config.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+// forward declarations
+
+namespace Ontology {
+    class System;
+    class World;
+}
+
+namespace Ontology {
+
+/*!
+ * @brief Updates a set of systems at a rate other than once per frame.
+ *
+ * Groups are created with SystemManager::addGroup() and systems are placed
+ * into them with System::inGroup(). A group either runs at a fixed timestep,
+ * catching up with the frame rate by running multiple times per frame if
+ * needed, or once every few frames:
+ * @code
+ * SystemGroup& physics = world.getSystemManager().addGroup("Physics")
+ *     .setFixedTimestep(1.0f / 60.0f);
+ * SystemGroup& ai = world.getSystemManager().addGroup("AI")
+ *     .setTickDivisor(6);
+ *
+ * world.getSystemManager().addSystem<CollisionSystem>()
+ *     .inGroup(physics);
+ * world.getSystemManager().addSystem<PathfindingSystem>()
+ *     .inGroup(ai);
+ * @endcode
+ * While a group runs, World::getDeltaTime() returns the time step of the
+ * group rather than the frame's delta time.
+ *
+ * All systems of a group run together, in their own execution order. The
+ * group is scheduled after every system any of its systems executes after,
+ * and before every system executing after one of its systems.
+ */
+class ONTOLOGY_PUBLIC_API SystemGroup
+{
+public:
+
+    /*!
+     * @brief Constructs a group running once per frame.
+     */
+    explicit SystemGroup(std::string name);
+
+    /*!
+     * @brief Gets the name of the group.
+     */
+    const std::string& getName() const;
+
+    /*!
+     * @brief Runs the group's systems at a fixed timestep.
+     *
+     * Frame time accumulates until it covers a step, so the group may run
+     * several times in a single frame or not at all.
+     * @param timestep The time step in the same unit as the world's delta
+     * time.
+     * @param maxSteps The maximum number of steps per frame. Time that can't
+     * be caught up with is dropped, so a slow frame doesn't cause even more
+     * steps the next frame.
+     * @return Returns a reference to this group, allowing the user to chain.
+     */
+    SystemGroup& setFixedTimestep(float timestep, unsigned int maxSteps = 5);
+
+    /*!
+     * @brief Runs each of the group's systems once every few frames.
+     * @param divisor The number of frames between two updates of a system.
+     * @param spread If true, the group's systems are spread evenly across
+     * those frames instead of all running in the same frame.
+     * @return Returns a reference to this group, allowing the user to chain.
+     */
+    SystemGroup& setTickDivisor(unsigned int divisor, bool spread = true);
+
+    /*!
+     * @brief Gets how far the fixed timestep accumulator has progressed into
+     * the next step, between 0 and 1. Useful for interpolating rendering.
+     */
+    float getInterpolation() const;
+
+    /*!
+     * @brief Runs the group's systems for the current frame.
+     * @note Should not be called by the user. This is an internal function.
+     */
+    ONTOLOGY_LOCAL_API void update(World* world);
+
+    /*!
+     * @brief Replaces the systems updated by this group.
+     * @note Should not be called by the user. This is an internal function.
+     */
+    ONTOLOGY_LOCAL_API void setSystems(std::vector<System*> systems);
+
+    /*!
+     * @brief Gets the systems updated by this group, in execution order.
+     */
+    ONTOLOGY_LOCAL_API const std::vector<System*>& getSystems() const;
+
+    /*!
+     * @brief Flags the group's list of systems as outdated.
+     * @note Should not be called by the user. This is an internal function.
+     */
+    ONTOLOGY_LOCAL_API void invalidate();
+
+    /*!
+     * @brief Returns true if the group's list of systems is outdated.
+     */
+    ONTOLOGY_LOCAL_API bool isInvalidated() const;
+
+private:
+
+    std::string             m_Name;
+    std::vector<System*>    m_Systems;
+    std::vector<float>      m_RecentDeltas;
+    float                   m_RecentDeltaSum;
+    float                   m_Timestep;
+    float                   m_Accumulator;
+    unsigned int            m_MaxSteps;
+    unsigned int            m_TickDivisor;
+    std::size_t             m_Frame;
+    bool                    m_Spread;
+    bool                    m_Invalidated;
+};
+
+} // namespace Ontology
+
+#endif // __ONTOLOGY_SYSTEM_GROUP_HPP__
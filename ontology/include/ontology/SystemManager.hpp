@@ -9,6 +9,8 @@
 // include files
 
 #include <ontology/Exception.hpp>
+#include <ontology/LambdaSystem.hpp>
+#include <ontology/SystemGroup.hpp>
 #include <ontology/SystemManager.hxx>
 #include <ontology/System.hpp>
 #include <ontology/Type.hpp>
@@ -26,16 +28,26 @@ inline T& SystemManager::addSystem(Args&&... args)
 template <class Base, class Derived, class... Args>
 Derived& SystemManager::addPolymorphicSystem(Args&&... args)
 {
-    ONTOLOGY_ASSERT(m_SystemList.find(&typeid(Base)) == m_SystemList.end(), DuplicateComponentException, "SystemManager::addPolymorphicSystem<Base, Derived, Args...>",
+    const TypeID typeID = System::SystemID::get<Base>();
+    ONTOLOGY_ASSERT(this->findSystem(typeID) == nullptr, DuplicateComponentException, "SystemManager::addPolymorphicSystem<Base, Derived, Args...>",
         std::string("System of type \"") + getTypeName<Base>() + "\" already registered with this manager"
     )
-    
+
     Derived* system = new Derived(args...);
-    m_SystemList.emplace_back(
-        &typeid(Base),
-        std::unique_ptr<Base>(system)
-    );
-    this->initSystem(system);
+    this->registerSystem(typeID, &typeid(Base), system, getTypeName<Base>());
+    return *system;
+}
+
+// ----------------------------------------------------------------------------
+template <class F>
+System& SystemManager::addSystem(const char* name, F function)
+{
+    // plain function pointers and std::function share their type between
+    // callables of the same signature, so lambda systems are registered under
+    // an ID of their own instead of one derived from their type
+    typedef LambdaSystemType<F> LambdaSystemT;
+    System* system = new LambdaSystemT(std::move(function));
+    this->registerSystem(System::SystemID::next(), &typeid(LambdaSystemT), system, name);
     return *system;
 }
 
@@ -43,12 +55,9 @@ Derived& SystemManager::addPolymorphicSystem(Args&&... args)
 template <class T>
 SystemManager& SystemManager::removeSystem()
 {
-    const auto it = m_SystemList.find(&typeid(T));
-    if(it == m_SystemList.end())
-        return *this;
-    
-    m_SystemList.erase(it);
-    this->computeExecutionOrder();
+    System* system = this->findSystem(System::SystemID::get<T>());
+    if(system != nullptr)
+        this->scheduleRemoval(system);
     return *this;
 }
 
@@ -56,11 +65,11 @@ SystemManager& SystemManager::removeSystem()
 template <class T>
 T* SystemManager::getSystemPtr() const
 {
-    const auto it = m_SystemList.find(&typeid(T));
-    ONTOLOGY_ASSERT(it != m_SystemList.end(), InvalidSystemException, SystemManager::getSystem<T>,
+    System* system = this->findSystem(System::SystemID::get<T>());
+    ONTOLOGY_ASSERT(system != nullptr, InvalidSystemException, SystemManager::getSystem<T>,
         std::string("System of type \"") + getTypeName<T>() + "\" not registered with this manager"
     )
-    return static_cast<T*>(it->second.get());
+    return static_cast<T*>(system);
 }
 
 // ----------------------------------------------------------------------------
@@ -74,9 +83,7 @@ inline T& SystemManager::getSystem() const
 template <class T>
 bool SystemManager::hasSystem() const
 {
-    if(m_SystemList.find(&typeid(T)) == m_SystemList.end())
-        return false;
-    return true;
+    return this->findSystem(System::SystemID::get<T>()) != nullptr;
 }
 
 } // namespace Ontology
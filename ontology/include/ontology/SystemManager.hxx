@@ -12,7 +12,10 @@
 #include <ontology/EntityManagerListener.hpp>
 #include <ontology/TypeContainers.hpp>
 
+#include <condition_variable>
+#include <exception>
 #include <iostream>
+#include <mutex>
 #include <set>
 #include <cassert>
 
@@ -21,6 +24,7 @@
 
 namespace Ontology {
     class System;
+    class SystemGroup;
     class World;
 }
 
@@ -99,6 +103,12 @@ public:
      * to the system manager is the order in which they are initialised.
      * Their destructors are called in reverse order when destroying the world.
      *
+     * @note Systems added after SystemManager::initialise() start
+     * initialising on the world's thread pool with the next update, while
+     * the other systems keep updating. They are inserted into the execution
+     * order with the first update after their initialisation finished, and
+     * after the systems they execute after.
+     *
      * @return Returns a reference to the newly added system.
      */
     template <class T, class... Args>
@@ -122,6 +132,28 @@ public:
     template <class Base, class Derived, class... Args>
     Derived& addPolymorphicSystem(Args&&... args);
 
+    /*!
+     * @brief Adds a new system processing entities with a callable.
+     *
+     * The supported components are deduced from the callable's parameters.
+     * Parameters taken by non-const reference are declared as written with
+     * System::writes(), all others as read with System::reads().
+     * @code
+     * world.getSystemManager().addSystem("Move", [](Position& p, const Velocity& v) {
+     *     p.x += v.x;
+     *     p.y += v.y;
+     * });
+     * @endcode
+     * The callable is invoked directly from the loop iterating the system's
+     * entities, without a virtual call per entity. Every call adds a system
+     * of its own, even for callables of the same type.
+     * @param name The name of the system, used when logging.
+     * @param function The callable processing each entity.
+     * @return Returns a reference to the newly added system.
+     */
+    template <class F>
+    System& addSystem(const char* name, F function);
+
     /*!
      * @brief Removes the specified system from the world.
      *
@@ -129,6 +161,11 @@ public:
      * @code
      * world.getSystemManager().removeSystem<MovementSystem>();
      * @endcode
+     * The system is unregistered immediately, but it is only destroyed and
+     * removed from the execution order at the start of the next update. This
+     * makes it safe to remove systems from within a running system.
+     *
+     * @note Removing a system other registered systems depend on is an error.
      * @return Returns a reference to this SystemManager, allowing the user
      * to chain.
      */
@@ -175,6 +212,22 @@ public:
     template <class T>
     bool hasSystem() const;
 
+    /*!
+     * @brief Adds a group of systems updating at their own rate.
+     *
+     * Add systems to the group with System::inGroup().
+     * @code
+     * SystemGroup& physics = world.getSystemManager().addGroup("Physics")
+     *     .setFixedTimestep(1.0f / 60.0f);
+     * world.getSystemManager().addSystem<CollisionSystem>()
+     *     .inGroup(physics);
+     * @endcode
+     * @return Returns a reference to the new group. It remains valid for the
+     * lifetime of the system manager.
+     * @see SystemGroup
+     */
+    SystemGroup& addGroup(const char* name);
+
     /*!
      * @brief Passes important data to a new System object so it functions correctly.
      * @note Should not be called by the user. This is an internal function.
@@ -190,11 +243,30 @@ public:
     /*!
      * @brief Initialises all currently registered systems.
      *
-     * @note The order in which the systems are added is the order in which
-     * they are initialised.
+     * Systems are initialised one after the other on the calling thread, in
+     * execution order. See SystemManager::setConcurrentInitialisation() to
+     * initialise them in parallel instead.
      */
     void initialise();
 
+    /*!
+     * @brief Controls whether SystemManager::initialise() initialises
+     * systems in parallel.
+     *
+     * Systems are initialised on the world's thread pool. A system only
+     * starts initialising once all systems it executes after have finished
+     * initialising, so declare those dependencies with
+     * System::executesAfter() if initialise() relies on another system.
+     * Only enable this if the initialise() methods of all systems follow the
+     * contract described at System::initialise().
+     * @code
+     * world.getSystemManager().setConcurrentInitialisation(true);
+     * world.getSystemManager().initialise();
+     * @endcode
+     * @note Use World::getThreadPool() to limit the number of threads.
+     */
+    SystemManager& setConcurrentInitialisation(bool concurrent=true);
+
     /*!
      * @brief Updates all currently registered systems. Don't call this.
      *
@@ -209,32 +281,126 @@ private:
     void onAddComponent(Entity&, const Component*) override;
     void onRemoveComponent(Entity&, const Component*) override;
     void onEntitiesReallocated(std::vector<Entity>&) override;
+    void onEntitiesMoved(std::vector<Entity>&, std::size_t, const std::vector<std::size_t>&) override;
+
+    /*!
+     * @brief Takes ownership of a new system and registers it under the
+     * specified SystemID.
+     */
+    void registerSystem(TypeID typeID, const std::type_info* type, System* system, std::string name);
 
     /*!
      * @brief Triggers dependency resolution of the system execution order.
      *
      * Systems are able to define which other systems should be executed before
      * them. This method resolves these dependencies so the execution order
-     * becomes known.
+     * becomes known. Systems without dependencies between them keep the
+     * order in which they were added.
+     * @note Circular dependencies are logged with World::log(). Unless
+     * assertions are enabled, the systems involved are left out of the
+     * execution order.
      */
     void computeExecutionOrder();
 
     /*!
-     * @brief Resolves system dependencies.
+     * @brief Initialises all systems, respecting their dependencies.
+     */
+    void initialiseSystems();
+
+    /*!
+     * @brief Reorders the execution order so the systems of every group are
+     * next to each other.
+     *
+     * Every group is treated as a single system depending on everything its
+     * systems depend on, so running a group at the position of its first
+     * system never runs a system before one it executes after.
+     */
+    void orderGroups();
+
+    /*!
+     * @brief Reports systems depending on systems that aren't registered.
+     *
+     * Such dependencies are logged, and ignored unless assertions are
+     * enabled.
+     */
+    void checkDependencies() const;
+
+    /*!
+     * @brief Builds the dependency graph of all registered systems.
+     *
+     * Systems are referred to by their position in the system list.
+     * @param unresolvedCount Receives the number of dependencies of every
+     * system.
+     * @param dependants Receives the systems depending on every system.
+     */
+    void buildDependencyGraph(std::vector<std::size_t>& unresolvedCount,
+                              std::vector< std::vector<std::size_t> >& dependants) const;
+
+    /*!
+     * @brief Unregisters a system and queues it for destruction.
+     */
+    void scheduleRemoval(System*);
+
+    /*!
+     * @brief Applies systems added and removed since the last update.
+     *
+     * Removed systems are dropped from the execution order and destroyed.
+     * Added systems are handed to the thread pool to initialise once the
+     * systems they execute after have initialised. Systems that finished
+     * initialising are inserted into the execution order directly after
+     * their last dependency, falling back to computeExecutionOrder() only if
+     * that would violate a dependency.
+     * @note Rethrows the first exception thrown by the initialisation of an
+     * added system.
+     */
+    void applyPendingChanges();
+
+    /*!
+     * @brief Initialises a system added at runtime on the thread pool.
+     */
+    void initialiseAsync(System*);
+
+    /*!
+     * @brief Checks if a system was added at runtime and isn't part of the
+     * execution order yet.
+     */
+    bool isBeingAdded(const System*) const;
+
+    /*!
+     * @brief Inserts a system into the existing execution order.
+     * @return False if the system can't be inserted without reordering other
+     * systems.
+     */
+    bool insertIntoExecutionOrder(System*);
+
+    /*!
+     * @brief Hands every group the list of its systems in execution order.
      */
-    TypeSet::iterator resolveDependencies(const std::type_info* node,
-                             const TypeMap<System*>& systemLookup,
-                             TypeSet& resolving,
-                             TypeSet& unresolved);
+    void rebuildGroups();
 
     /*!
-     * @brief Returns true if the specified system is part of the execution list.
+     * @brief Looks up a registered system by its SystemID.
+     * @return The system, or nullptr if no system is registered under the ID.
      */
-    bool isInExecutionList(const System* const) const;
+    System* findSystem(TypeID typeID) const;
 
     TypeVectorPairUniquePtr<System> m_SystemList;
+    std::vector<System*>            m_SystemIndex;
     std::vector<System*>            m_ExecutionList;
+    std::vector<System*>            m_PendingAdditions;
+    std::vector<System*>            m_InitialisingSystems;
+    std::vector<System*>            m_ReadyAdditions;
+    std::vector<System*>            m_PendingRemovals;
+    std::vector<System*>            m_InitialisedSystems;
+    std::exception_ptr              m_InitialiseException;
+    std::mutex                      m_InitialisedMutex;
+    std::condition_variable         m_SystemInitialised;
+    std::vector< std::unique_ptr<SystemGroup> > m_Groups;
     World*                          m_World;
+    std::size_t                     m_DestroyedEntity;
+    bool                            m_Initialised;
+    bool                            m_GroupsChanged;
+    bool                            m_ConcurrentInitialisation;
 };
 
 } // namespace Ontology
@@ -0,0 +1,171 @@
+// ----------------------------------------------------------------------------
+// ThreadPool.hpp
+// ----------------------------------------------------------------------------
+
+#ifndef __ONTOLOGY_THREAD_POOL_HPP__
+#define __ONTOLOGY_THREAD_POOL_HPP__
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <ontology/Config.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Ontology {
+
+/*!
+ * @brief A fixed set of worker threads executing queued tasks.
+ *
+ * Every world owns a thread pool, see World::getThreadPool(). The workers
+ * are only started when the first task is queued, so worlds that never
+ * use them don't pay for idle threads.
+ * @code
+ * ThreadPool& pool = world.getThreadPool();
+ * pool.enqueue([]() { loadAssets(); });
+ * pool.enqueue([]() { buildNavMesh(); });
+ * pool.wait();
+ * @endcode
+ * @note Tasks may queue further tasks. ThreadPool::wait() returns once all
+ * of them have finished.
+ */
+class ONTOLOGY_PUBLIC_API ThreadPool
+{
+public:
+
+    typedef std::function<void()> Task;
+
+    /// Processes the half-open range of indices [first, last).
+    typedef std::function<void(std::size_t first, std::size_t last)> RangeTask;
+
+    /*!
+     * @brief Constructs a pool without starting any threads.
+     * @param threadCount The number of workers to start. 0 uses one worker
+     * per hardware thread.
+     */
+    explicit ThreadPool(std::size_t threadCount = 0);
+
+    /*!
+     * @brief Waits for all queued tasks, then joins the workers.
+     */
+    ~ThreadPool();
+
+    /*!
+     * @brief Changes the number of workers.
+     *
+     * Waits for all queued tasks and joins the current workers. The new
+     * workers are started when the next task is queued.
+     * @param threadCount The number of workers. 0 uses one worker per
+     * hardware thread.
+     */
+    void setThreadCount(std::size_t threadCount);
+
+    /*!
+     * @brief Gets the number of workers the pool runs tasks on.
+     */
+    std::size_t getThreadCount() const;
+
+    /*!
+     * @brief Queues a task to be executed by the next idle worker.
+     * @note This function is thread safe.
+     */
+    void enqueue(Task task);
+
+    /*!
+     * @brief Splits a range of indices into chunks processed in parallel.
+     *
+     * The calling thread processes chunks as well, and only returns once all
+     * chunks have been processed. This makes it safe to call from within a
+     * task running on this pool.
+     * @code
+     * pool.parallelFor(particles.size(), 256, [&](std::size_t first, std::size_t last) {
+     *     for(std::size_t i = first; i != last; ++i)
+     *         particles[i].integrate();
+     * });
+     * @endcode
+     * @param count The number of indices.
+     * @param grainSize The number of indices per chunk.
+     * @param task Called once per chunk. If a chunk throws, the first
+     * exception thrown is rethrown after all chunks have finished.
+     */
+    void parallelFor(std::size_t count, std::size_t grainSize, const RangeTask& task);
+
+    /*!
+     * @brief Reduces a range of indices in parallel, in a fixed order.
+     *
+     * Every chunk is reduced separately, then the chunk results are combined
+     * in chunk order. As the chunks only depend on the grain size, the result
+     * is identical for any number of threads, even for operations such as
+     * floating point addition that aren't associative.
+     * @code
+     * float mass = pool.parallelReduce(bodies.size(), 256, 0.0f,
+     *     [&](std::size_t i) { return bodies[i].mass; },
+     *     [](float a, float b) { return a + b; });
+     * @endcode
+     * @param count The number of indices.
+     * @param grainSize The number of indices per chunk.
+     * @param identity The value to start every chunk with.
+     * @param map Called with every index, returns the value to reduce.
+     * @param combine Combines two values.
+     */
+    template <class T, class Map, class Combine>
+    T parallelReduce(std::size_t count, std::size_t grainSize, T identity, Map map, Combine combine);
+
+    /*!
+     * @brief Blocks until all queued tasks have finished.
+     *
+     * If a task threw, the first exception thrown is rethrown here.
+     */
+    void wait();
+
+private:
+
+    void start();
+    void stop();
+    void run();
+
+    std::vector<std::thread>    m_Threads;
+    std::deque<Task>            m_Tasks;
+    std::mutex                  m_Mutex;
+    std::condition_variable     m_TaskQueued;
+    std::condition_variable     m_TasksFinished;
+    std::exception_ptr          m_Exception;
+    std::size_t                 m_ThreadCount;
+    std::size_t                 m_UnfinishedTasks;
+    bool                        m_Stopping;
+};
+
+// ----------------------------------------------------------------------------
+template <class T, class Map, class Combine>
+T ThreadPool::parallelReduce(std::size_t count, std::size_t grainSize, T identity, Map map, Combine combine)
+{
+    // chunks write their results concurrently, which std::vector<bool> can't handle
+    static_assert(!std::is_same<T, bool>::value, "parallelReduce doesn't support bool, use int instead");
+
+    if(grainSize == 0)
+        grainSize = 1;
+    std::vector<T> chunkResults((count + grainSize - 1) / grainSize, identity);
+    this->parallelFor(count, grainSize, [&](std::size_t first, std::size_t last) {
+        T result = identity;
+        for(std::size_t i = first; i != last; ++i)
+            result = combine(result, map(i));
+        chunkResults[first / grainSize] = result;
+    });
+
+    T result = identity;
+    for(const auto& chunkResult : chunkResults)
+        result = combine(result, chunkResult);
+    return result;
+}
+
+} // namespace Ontology
+
+#endif // __ONTOLOGY_THREAD_POOL_HPP__
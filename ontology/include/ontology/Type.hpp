@@ -10,6 +10,8 @@
 
 #include "Type.hxx"
 
+#include <typeinfo>
+
 template <class T>
 std::string getTypeName()
 {
@@ -8,6 +8,8 @@
 // ----------------------------------------------------------------------------
 // include files
 
+#include <atomic>
+#include <cstddef>
 #include <typeinfo>
 #include <vector>
 #include <set>
@@ -16,6 +18,54 @@
 
 namespace Ontology {
 
+/// A dense, zero-based identifier handed out to a type at runtime.
+typedef std::size_t TypeID;
+
+/*!
+ * @brief Hands out dense TypeIDs, counting separately for every family.
+ *
+ * The first type to ask a family for its ID receives 0, the next 1, and so
+ * on. This allows type-keyed lookups to index a plain vector instead of
+ * searching a map.
+ * @code
+ * struct SingletonFamily;
+ * TypeID id = TypeIDGenerator<SingletonFamily>::get<Input>();
+ * @endcode
+ */
+template <class Family>
+class TypeIDGenerator
+{
+public:
+
+    /// Gets the ID of the specified type within this family.
+    template <class T>
+    static TypeID get()
+    {
+        static const TypeID id = counter()++;
+        return id;
+    }
+
+    /// Hands out an ID not bound to any type.
+    static TypeID next()
+    {
+        return counter()++;
+    }
+
+    /// Gets the number of IDs handed out so far.
+    static TypeID count()
+    {
+        return counter().load();
+    }
+
+private:
+
+    static std::atomic<TypeID>& counter()
+    {
+        static std::atomic<TypeID> value(0);
+        return value;
+    }
+};
+
 /*!
  * @brief Entity comparator for entry in std::set and std::map.
  * @note see http://stackoverflow.com/questions/8682582/what-is-type-infobefore-useful-for
@@ -8,88 +8,93 @@
 // ----------------------------------------------------------------------------
 // include files
 
-#include <ontology/Config.hpp>
+#include <ontology/EventChannel.hpp>
+#include <ontology/Exception.hpp>
+#include <ontology/SpatialIndex.hpp>
+#include <ontology/ThreadPool.hpp>
+#include <ontology/Type.hpp>
+#include <ontology/World.hxx>
 
-#include <vector>
-#include <memory>
+namespace Ontology {
 
 // ----------------------------------------------------------------------------
-// forward declarations
-
-namespace Ontology {
-    class EntityManager;
-    class SystemManager;
+template <class T, class... Args>
+T& World::addSingleton(Args&&... args)
+{
+    ONTOLOGY_ASSERT(!this->hasSingleton<T>(), DuplicateSingletonException, World::addSingleton<T>,
+        std::string("Singleton of type \"") + getTypeName<T>() + "\" already stored in this world"
+    )
+
+    const TypeID id = SingletonID::get<T>();
+    if(m_Singletons.size() <= id)
+        m_Singletons.resize(id + 1);
+
+    T* singleton = new T(args...);
+    m_Singletons[id] = std::shared_ptr<T>(singleton);
+    this->markChanged<T>();
+    return *singleton;
 }
 
-namespace Ontology {
-
-/*!
- * @brief The world is the entry point to the framework.
- * Usually one instance of World is enough, but there's no reason not to have
- * multiple worlds. Instances of Entity, Component and System cannot be
- * transferred between worlds. What can be done is to dispatch listener events
- * from one system in one world to another system in another world. They will
- * have to register to each other in order for this to work.
- *
- * World has two main parts. It has an EntityManager and a SystemManager. These
- * are responsible for adding and removing entities, components and systems to
- * your world.
- * 
- * World has a method, World::update(), which will udpate all registered
- * systems.
- *
- * The world also stores a delta time, which can be accessed from within any
- * registered system.
- */
-class ONTOLOGY_PUBLIC_API World
+// ----------------------------------------------------------------------------
+template <class T>
+void World::removeSingleton()
 {
-public:
-
-    /*!
-     * @brief Default constructor.
-     */
-    World();
-
-    /*!
-     * @brief Default destructor.
-     */
-    ~World();
-
-    /*!
-     * @brief Gets this world's entity manager.
-     */
-    EntityManager& getEntityManager() const;
+    const TypeID id = SingletonID::get<T>();
+    if(id < m_Singletons.size() && m_Singletons[id])
+    {
+        m_Singletons[id].reset();
+        this->markChanged<T>();
+    }
+}
 
-    /*!
-     * @brief Gets this world's system manager.
-     */
-    SystemManager& getSystemManager() const;
+// ----------------------------------------------------------------------------
+template <class T>
+inline T& World::singleton() const
+{
+    ONTOLOGY_ASSERT(this->hasSingleton<T>(), InvalidSingletonException, World::singleton<T>,
+        std::string("Singleton of type \"") + getTypeName<T>() + "\" not stored in this world"
+    )
+    return *static_cast<T*>(m_Singletons[SingletonID::get<T>()].get());
+}
 
-    /*!
-     * @brief Sets the world's delta time.
-     *
-     * The delta time is usually used by systems via World::getDeltaTime().
-     * when processing entities.
-     * @param delta Delta time to set.
-     */
-    void setDeltaTime(float delta);
+// ----------------------------------------------------------------------------
+template <class T>
+bool World::hasSingleton() const
+{
+    const TypeID id = SingletonID::get<T>();
+    if(id >= m_Singletons.size())
+        return false;
+    return m_Singletons[id] != nullptr;
+}
 
-    /*!
-     * @brief Gets the world's delta time.
-     */
-    float getDeltaTime() const;
+// ----------------------------------------------------------------------------
+template <class T>
+EventChannel<T>& World::events()
+{
+    const TypeID eventID = EventID::get<T>();
+    EventChannelBase* channel = this->getEventChannel(eventID);
+    if(channel == nullptr)
+        channel = this->addEventChannel(eventID, new EventChannel<T>);
+    return *static_cast<EventChannel<T>*>(channel);
+}
 
-    /*!
-     * @brief Update all systems.
-     */
-    void update();
+// ----------------------------------------------------------------------------
+template <class T>
+SpatialIndex& World::addSpatialIndex(float cellSize, std::function<SpatialPoint(const T&)> position)
+{
+    m_SpatialIndex.reset(new SpatialIndex(&typeid(T), cellSize,
+        SpatialIndex::makePositionFunction<T, Entity>(std::move(position))));
+    return *m_SpatialIndex;
+}
 
-private:
-    std::unique_ptr<EntityManager>  m_EntityManager;
-    std::unique_ptr<SystemManager>  m_SystemManager;
-    float                           m_DeltaTime;
-};
+// ----------------------------------------------------------------------------
+template <class T>
+inline void World::markChanged()
+{
+    static const TypeID changeID = World::getChangeID(&typeid(T));
+    this->markChanged(changeID);
+}
 
 } // namespace Ontology
 
-#endif // __ONTOLOGY_WORLD_HPP__
\ No newline at end of file
+#endif // __ONTOLOGY_WORLD_HPP__
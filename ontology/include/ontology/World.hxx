@@ -0,0 +1,366 @@
+// ----------------------------------------------------------------------------
+// World.hxx
+// ----------------------------------------------------------------------------
+
+#ifndef __ONTOLOGY_WORLD_HXX__
+#define __ONTOLOGY_WORLD_HXX__
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <ontology/Config.hpp>
+#include <ontology/Entity.hxx>
+#include <ontology/TypeContainers.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+// forward declarations
+
+namespace Ontology {
+    class EntityManager;
+    class EventChannelBase;
+    template <class T> class EventChannel;
+    class FrameAllocator;
+    class Hierarchy;
+    class SpatialIndex;
+    struct SpatialPoint;
+    class SystemManager;
+    class ThreadPool;
+}
+
+namespace Ontology {
+
+/*!
+ * @brief The world is the entry point to the framework.
+ * Usually one instance of World is enough, but there's no reason not to have
+ * multiple worlds. Instances of Entity, Component and System cannot be
+ * transferred between worlds. What can be done is to dispatch listener events
+ * from one system in one world to another system in another world. They will
+ * have to register to each other in order for this to work.
+ *
+ * World has two main parts. It has an EntityManager and a SystemManager. These
+ * are responsible for adding and removing entities, components and systems to
+ * your world.
+ * 
+ * World has a method, World::update(), which will udpate all registered
+ * systems.
+ *
+ * The world also stores a delta time, which can be accessed from within any
+ * registered system.
+ *
+ * Global state that doesn't belong to any particular entity (input, camera,
+ * time, ...) can be stored as a singleton. Every type can be stored once per
+ * world and is looked up in constant time:
+ * @code
+ * world.addSingleton<Camera>(0, 0);
+ * // later, from within a system
+ * Camera& camera = world->singleton<Camera>();
+ * @endcode
+ * Systems accessing a singleton should declare so with System::reads() or
+ * System::writes().
+ *
+ * Messages from the world and its systems are passed to a logger, which
+ * prints to std::cout unless replaced with World::setLogger().
+ */
+class ONTOLOGY_PUBLIC_API World
+{
+public:
+
+    /*!
+     * @brief Default constructor.
+     */
+    World();
+
+    /*!
+     * @brief Default destructor.
+     */
+    ~World();
+
+    /*!
+     * @brief Gets this world's entity manager.
+     */
+    EntityManager& getEntityManager() const;
+
+    /*!
+     * @brief Gets this world's system manager.
+     */
+    SystemManager& getSystemManager() const;
+
+    /*!
+     * @brief Gets the pool of worker threads used by this world.
+     */
+    ThreadPool& getThreadPool() const;
+
+    /*!
+     * @brief Gets the allocator for data that only lives for the current frame.
+     *
+     * Every thread allocates from its own arena. All allocations are freed at
+     * the end of World::update().
+     * @see FrameAllocator
+     */
+    FrameAllocator& getFrameAllocator() const;
+
+    /*!
+     * @brief Gets the parent/child relations between this world's entities.
+     * @see Hierarchy
+     */
+    Hierarchy& getHierarchy() const;
+
+    /*!
+     * @brief Receives every message logged with World::log().
+     */
+    typedef std::function<void(const std::string&)> Logger;
+
+    /*!
+     * @brief Replaces the logger.
+     *
+     * The default logger prints messages to std::cout.
+     * @code
+     * world.setLogger([](const std::string& message) {
+     *     serverLog.info(message);
+     * });
+     * @endcode
+     * @note The logger is never called by two threads at the same time.
+     */
+    void setLogger(Logger logger);
+
+    /*!
+     * @brief Passes a message to the logger.
+     * @note This function is thread safe.
+     */
+    void log(const std::string& message) const;
+
+    /*!
+     * @brief Makes parallel processing independent of threads and timing.
+     *
+     * Lockstep simulations require bit-identical results on every machine.
+     * In deterministic mode, systems split their entities into chunks of a
+     * fixed size regardless of the number of threads or measured costs.
+     * Command buffers are applied in chunk order and reductions combine their
+     * chunks in order, so the results don't depend on which thread processed
+     * which chunk.
+     * @note Systems must only write shared state through command buffers and
+     * reductions for this to hold.
+     */
+    void setDeterministic(bool deterministic);
+
+    /*!
+     * @brief Returns true if the world is in deterministic mode.
+     */
+    bool isDeterministic() const;
+
+    /*!
+     * @brief Sets the world's delta time.
+     *
+     * The delta time is usually used by systems via World::getDeltaTime().
+     * when processing entities.
+     * @param delta Delta time to set.
+     */
+    void setDeltaTime(float delta);
+
+    /*!
+     * @brief Gets the world's delta time.
+     */
+    float getDeltaTime() const;
+
+    /*!
+     * @brief Stores a singleton in the world.
+     *
+     * The type of singleton is passed as a template argument. If it has a
+     * constructor that requires arguments, those can be directly supplied as
+     * arguments to this function.
+     * @code
+     * world.addSingleton<Camera>(0, 0);
+     * @endcode
+     * @note You can only store one instance of every type.
+     * @return Returns a reference to the new singleton.
+     */
+    template <class T, class... Args>
+    T& addSingleton(Args&&... args);
+
+    /*!
+     * @brief Destroys the specified singleton, if it exists.
+     */
+    template <class T>
+    void removeSingleton();
+
+    /*!
+     * @brief Gets the specified singleton.
+     * @return A reference to the requested singleton.
+     */
+    template <class T>
+    inline T& singleton() const;
+
+    /*!
+     * @brief Checks if the specified singleton exists.
+     * @return True if the world stores the singleton, false if otherwise.
+     */
+    template <class T>
+    bool hasSingleton() const;
+
+    /*!
+     * @brief Gets the channel for events of the specified type.
+     *
+     * The channel is created the first time it is requested.
+     * @code
+     * world.events<Collision>().send(Collision(a, b));
+     * @endcode
+     * @note This function is thread safe.
+     * @see EventChannel
+     */
+    template <class T>
+    EventChannel<T>& events();
+
+    /*!
+     * @brief Appends events posted from other threads to their channels.
+     * @note Should not be called by the user. This is an internal function.
+     */
+    ONTOLOGY_LOCAL_API void flushEvents();
+
+    /*!
+     * @brief Flags components or singletons of the specified type as changed.
+     *
+     * Systems declared with System::runIfChanged() only run if one of the
+     * types they depend on changed since they last ran. Adding or removing
+     * components and singletons, as well as running a system declaring
+     * System::writes() on a type, flags the type as changed automatically.
+     * Modifications made any other way must be flagged manually:
+     * @code
+     * world.getEntityManager().getEntity(id).getComponent<Position>().x = 5;
+     * world.markChanged<Position>();
+     * @endcode
+     */
+    template <class T>
+    inline void markChanged();
+
+    /*!
+     * @brief Flags the specified type as changed.
+     * @note This function is thread safe and doesn't lock.
+     */
+    void markChanged(const std::type_info* type);
+
+    /*!
+     * @brief Flags the type with the specified change ID as changed.
+     * @see World::getChangeID()
+     */
+    void markChanged(TypeID changeID);
+
+    /*!
+     * @brief Gets the dense ID changes of the specified type are tracked
+     * under.
+     *
+     * Looking up the ID of a type only locks the first time the type is
+     * seen. Callers knowing the type at compile time can cache the ID, see
+     * World::markChanged<T>().
+     */
+    static TypeID getChangeID(const std::type_info* type);
+
+    /*!
+     * @brief Gets the change tick the specified type was last changed at.
+     *
+     * Every change advances a world-wide tick, so a type changed after a
+     * given tick has a greater change tick.
+     * @return The change tick, or 0 if the type never changed.
+     * @note This function is thread safe and doesn't lock.
+     */
+    std::uint64_t getChangeTick(const std::type_info* type) const;
+
+    /*!
+     * @brief Gets the change tick the type with the specified change ID was
+     * last changed at.
+     * @see World::getChangeID()
+     */
+    std::uint64_t getChangeTick(TypeID changeID) const;
+
+    /*!
+     * @brief Gets the tick of the most recent change of any type.
+     */
+    std::uint64_t getChangeTick() const;
+
+    /*!
+     * @brief Attaches a spatial index to the component storing positions.
+     *
+     * Replaces any previously added index.
+     * @code
+     * world.addSpatialIndex<Position>(10.0f, [](const Position& position) {
+     *     return SpatialIndex::Point(position.x, position.y);
+     * });
+     * @endcode
+     * @param cellSize The edge length of a grid cell, see SpatialIndex.
+     * @param position Reads the position from a component.
+     * @return A reference to the new index.
+     */
+    template <class T>
+    SpatialIndex& addSpatialIndex(float cellSize, std::function<SpatialPoint(const T&)> position);
+
+    /*!
+     * @brief Gets all entities within a radius of a point.
+     * @note Requires a spatial index, see World::addSpatialIndex().
+     */
+    std::vector<Entity::ID> queryRadius(SpatialPoint center, float radius) const;
+
+    /*!
+     * @brief Gets all entities within an axis aligned box.
+     * @note Requires a spatial index, see World::addSpatialIndex().
+     */
+    std::vector<Entity::ID> queryAABB(SpatialPoint min, SpatialPoint max) const;
+
+    /*!
+     * @brief Update all systems, then free the frame allocator's memory.
+     */
+    void update();
+
+private:
+
+    /// Singletons are identified by a dense ID within their own family.
+    typedef TypeIDGenerator<World> SingletonID;
+
+    /// Event channels are identified by a dense ID within their own family.
+    typedef TypeIDGenerator<EventChannelBase> EventID;
+
+    /*!
+     * @brief Gets the channel of the specified event ID, or nullptr if it
+     * wasn't created yet.
+     */
+    EventChannelBase* getEventChannel(TypeID eventID) const;
+
+    /*!
+     * @brief Stores a new channel, unless another thread stored one first.
+     * @return The stored channel. The passed channel is destroyed if it
+     * wasn't stored.
+     */
+    EventChannelBase* addEventChannel(TypeID eventID, EventChannelBase* channel);
+
+    std::unique_ptr<ThreadPool>         m_ThreadPool;
+    std::unique_ptr<FrameAllocator>     m_FrameAllocator;
+    std::unique_ptr<EntityManager>      m_EntityManager;
+    std::unique_ptr<SystemManager>      m_SystemManager;
+    std::unique_ptr<Hierarchy>          m_Hierarchy;
+    std::unique_ptr<SpatialIndex>       m_SpatialIndex;
+    std::vector<std::shared_ptr<void>>  m_Singletons;
+    // event channels indexed by event ID, in blocks of 64, 128, ... entries,
+    // so looking up a channel doesn't require a lock
+    static const std::size_t            EventChannelBlockCount = 20;
+    std::atomic<std::atomic<EventChannelBase*>*> m_EventChannelBlocks[EventChannelBlockCount];
+    // change ticks indexed by change ID, in blocks of 64, 128, ... entries,
+    // enough to cover every change ID
+    static const std::size_t            ChangeTickBlockCount = 7;
+    std::atomic<std::atomic<std::uint64_t>*> m_ChangeTickBlocks[ChangeTickBlockCount];
+    std::atomic<std::uint64_t>          m_ChangeTick;
+    Logger                              m_Logger;
+    mutable std::mutex                  m_LoggerMutex;
+    float                               m_DeltaTime;
+    bool                                m_Deterministic;
+};
+
+} // namespace Ontology
+
+#endif // __ONTOLOGY_WORLD_HXX__
\ No newline at end of file
@@ -0,0 +1,54 @@
+// ----------------------------------------------------------------------------
+// CommandBuffer.cpp
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <ontology/CommandBuffer.hpp>
+
+namespace Ontology {
+
+// ----------------------------------------------------------------------------
+void CommandBuffer::push(Command command)
+{
+    m_Commands.push_back(std::move(command));
+}
+
+// ----------------------------------------------------------------------------
+void CommandBuffer::createEntity(const char* name, std::function<void(Entity&)> initialiser)
+{
+    m_Commands.push_back([name, initialiser](World& world) {
+        Entity& entity = world.getEntityManager().createEntity(name);
+        if(initialiser)
+            initialiser(entity);
+    });
+}
+
+// ----------------------------------------------------------------------------
+void CommandBuffer::destroyEntity(Entity::ID entity)
+{
+    m_Commands.push_back([entity](World& world) {
+        world.getEntityManager().destroyEntity(
+            world.getEntityManager().getEntity(entity)
+        );
+    });
+}
+
+// ----------------------------------------------------------------------------
+void CommandBuffer::apply(World& world)
+{
+    // swap first, so commands can safely record into this buffer again
+    std::vector<Command> commands;
+    commands.swap(m_Commands);
+    for(const auto& command : commands)
+        command(world);
+}
+
+// ----------------------------------------------------------------------------
+std::size_t CommandBuffer::size() const
+{
+    return m_Commands.size();
+}
+
+} // namespace Ontology
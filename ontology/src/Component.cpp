@@ -7,8 +7,38 @@
 
 #include <ontology/Component.hpp>
 
+#include <atomic>
+#include <mutex>
+
 namespace Ontology {
 
+// ----------------------------------------------------------------------------
+// Tag IDs are handed out lazily from whichever thread first touches a tag
+// type, so the registry is guarded.
+static std::mutex& getTagRegistryMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+// ----------------------------------------------------------------------------
+// Instances are stored in blocks of doubling size that never move once
+// allocated, so entities can look up a registered tag without the lock.
+static const TypeID FirstTagBlockSize = 64;
+static const std::size_t MaxTagBlockCount = 32;
+static std::atomic<Component**> tagBlocks[MaxTagBlockCount];
+static TypeID tagCount = 0;
+
+// ----------------------------------------------------------------------------
+static std::size_t getTagBlock(TypeID tagID, TypeID& blockBegin)
+{
+    std::size_t block = 0;
+    blockBegin = 0;
+    while(tagID >= blockBegin + (FirstTagBlockSize << block))
+        blockBegin += FirstTagBlockSize << block++;
+    return block;
+}
+
 // ----------------------------------------------------------------------------
 Component::Component()
 {
@@ -19,4 +49,26 @@ Component::~Component()
 {
 }
 
+// ----------------------------------------------------------------------------
+TypeID registerTagComponent(Component* instance)
+{
+    std::lock_guard<std::mutex> guard(getTagRegistryMutex());
+    const TypeID tagID = tagCount++;
+
+    TypeID blockBegin;
+    const std::size_t block = getTagBlock(tagID, blockBegin);
+    if(tagID == blockBegin)
+        tagBlocks[block].store(new Component*[FirstTagBlockSize << block](), std::memory_order_release);
+    tagBlocks[block].load(std::memory_order_relaxed)[tagID - blockBegin] = instance;
+    return tagID;
+}
+
+// ----------------------------------------------------------------------------
+Component* getTagComponentInstance(TypeID tagID)
+{
+    TypeID blockBegin;
+    const std::size_t block = getTagBlock(tagID, blockBegin);
+    return tagBlocks[block].load(std::memory_order_acquire)[tagID - blockBegin];
+}
+
 } // namespace Ontology
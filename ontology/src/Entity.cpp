@@ -11,12 +11,14 @@
 namespace Ontology {
 
 Entity::ID Entity::GUIDCounter = 0;
+const TypeID Entity::InlineTagCount;
 
 // ----------------------------------------------------------------------------
 Entity::Entity(const char* name, const EntityManagerInterface* creator) :
     m_Name(name),
     m_Creator(creator),
-    m_ID(GUIDCounter++)
+    m_ID(GUIDCounter++),
+    m_TagSignature(0)
 {
 }
 
@@ -26,17 +28,62 @@ Entity::~Entity()
     // dispatch remove component events
     for(const auto& it : m_ComponentMap)
         m_Creator->informRemoveComponent(*this, it.second.get());
+    for(TypeID tagID = 0; tagID != InlineTagCount && (m_TagSignature >> tagID); ++tagID)
+        if((m_TagSignature >> tagID) & 1)
+            m_Creator->informRemoveComponent(*this, getTagComponentInstance(tagID));
+    for(TypeID tagID = 0; tagID != m_TagOverflow.size(); ++tagID)
+        if(m_TagOverflow[tagID])
+            m_Creator->informRemoveComponent(*this, getTagComponentInstance(InlineTagCount + tagID));
 }
 
 // ----------------------------------------------------------------------------
 bool Entity::supportsSystem(const System& system) const
 {
-    for(const auto& it : system.getSupportedComponents())
+    for(const auto& it : system.getSupportedDataComponents())
         if(m_ComponentMap.find(it) == m_ComponentMap.end())
             return false;
+    for(const auto& it : system.getSupportedTags())
+        if(!this->hasTag(it))
+            return false;
     return true;
 }
 
+// ----------------------------------------------------------------------------
+Entity& Entity::addListener(EntityListener* listener)
+{
+    m_Creator->addEntityListener(m_ID, listener);
+    return *this;
+}
+
+// ----------------------------------------------------------------------------
+void Entity::removeListener(EntityListener* listener)
+{
+    m_Creator->removeEntityListener(m_ID, listener);
+}
+
+// ----------------------------------------------------------------------------
+std::shared_ptr<const Component> Entity::getComponentHandle(const Component* component) const
+{
+    const auto it = m_ComponentMap.find(&typeid(*component));
+    if(it != m_ComponentMap.end() && it->second.get() == component)
+        return it->second;
+
+    // tags are static instances, so a handle not owning anything suffices
+    return std::shared_ptr<const Component>(std::shared_ptr<const Component>(), component);
+}
+
+// ----------------------------------------------------------------------------
+void Entity::swap(Entity& other)
+{
+    std::swap(m_ID, other.m_ID);
+    m_ComponentMap.swap(other.m_ComponentMap);
+    std::swap(m_TagSignature, other.m_TagSignature);
+    m_TagOverflow.swap(other.m_TagOverflow);
+    m_SharedComponents.swap(other.m_SharedComponents);
+    std::swap(m_Name, other.m_Name);
+    std::swap(m_Creator, other.m_Creator);
+}
+
 // ----------------------------------------------------------------------------
 const char* Entity::getName() const
 {
@@ -6,18 +6,21 @@
 // include files
 
 #include <ontology/Entity.hpp>
+#include <ontology/EntityListener.hpp>
 #include <ontology/EntityManager.hpp>
 #include <ontology/EntityManagerListener.hpp>
 
+#include <algorithm>
 #include <sstream>
 #include <stdexcept>
-#include <string.h>
 
 namespace Ontology {
 
 // ----------------------------------------------------------------------------
 EntityManager::EntityManager(World* world) :
-    EntityManagerInterface(world)
+    EntityManagerInterface(world),
+    m_RelocatingEntities(false),
+    m_ReleasingDestroyedEntity(false)
 {
     m_EntityListCapacity = m_EntityList.capacity();
 }
@@ -31,8 +34,19 @@ EntityManager::~EntityManager()
 // ----------------------------------------------------------------------------
 Entity& EntityManager::createEntity(const char* name)
 {
-    m_EntityList.emplace_back(name, this);
-    this->event.dispatch(&EntityManagerListener::onCreateEntity, m_EntityList.back());
+    // the name index owns the names of all entities, so equal names share
+    // one string and compare by pointer
+    const auto nameIt = m_NameIndex.emplace(std::string(name), std::vector<Entity::ID>()).first;
+
+    // growing the list copies entities and destroys the originals, which
+    // entity listeners must not mistake for removed components
+    m_RelocatingEntities = true;
+    m_EntityList.emplace_back(nameIt->first.c_str(), this);
+    m_RelocatingEntities = false;
+    Entity& entity = m_EntityList.back();
+    m_EntityIndex[entity.getID()] = m_EntityList.size() - 1;
+    nameIt->second.push_back(entity.getID());
+    this->event.dispatch(&EntityManagerListener::onCreateEntity, entity);
     this->handleEntityReallocation();
     return m_EntityList.back();
 }
@@ -40,59 +54,52 @@ Entity& EntityManager::createEntity(const char* name)
 // ----------------------------------------------------------------------------
 void EntityManager::destroyEntity(Entity& entity)
 {
-    for(auto it = m_EntityList.begin(); it != m_EntityList.end(); ++it)
-    {
-        if(&(*it) == &entity)
-        {
-            this->event.dispatch(&EntityManagerListener::onDestroyEntity, entity);
-            m_EntityList.erase(it);
-            this->handleEntityReallocation(true);
-            return;
-        }
-    }
+    const auto it = m_EntityIndex.find(entity.getID());
+    if(it == m_EntityIndex.end() || &m_EntityList[it->second] != &entity)
+        return;
+
+    const Entity::ID entityID = entity.getID();
+    const std::string name = entity.getName();
+    this->destroyEntityAt(it->second);
+
+    auto& entityIDs = m_NameIndex[name];
+    entityIDs.erase(std::find(entityIDs.begin(), entityIDs.end(), entityID));
+    if(entityIDs.empty())
+        m_NameIndex.erase(name);
 }
 
 // ----------------------------------------------------------------------------
 void EntityManager::destroyEntities(const char* name)
 {
-    auto it = m_EntityList.begin();
-    bool requireReallocationEvent = false;
-    while(it != m_EntityList.end())
-    {
-        if(!strcmp(it->getName(), name))
-        {
-            this->event.dispatch(&EntityManagerListener::onDestroyEntity, *it);
-            it = m_EntityList.erase(it);
-            requireReallocationEvent = true;
-        }
-        else
-        {
-            ++it;
-        }
-    }
-    
-    if(requireReallocationEvent)
-        this->handleEntityReallocation(true);
+    // the name may belong to one of the entities
+    const std::string key(name);
+    const auto it = m_NameIndex.find(key);
+    if(it == m_NameIndex.end())
+        return;
+
+    // the entities still refer to the name while they are destroyed, so it
+    // is released last
+    const std::vector<Entity::ID> entityIDs = it->second;
+    for(const auto& entityID : entityIDs)
+        this->destroyEntityAt(m_EntityIndex[entityID]);
+    m_NameIndex.erase(key);
 }
 
 // ----------------------------------------------------------------------------
 void EntityManager::destroyAllEntities()
 {
-    auto it = m_EntityList.begin();
-    while(it != m_EntityList.end())
-    {
-        this->event.dispatch(&EntityManagerListener::onDestroyEntity, *it);
-        it = m_EntityList.erase(it);
-    }
-    this->handleEntityReallocation(true);
+    // back to front, so no entity has to move
+    while(!m_EntityList.empty())
+        this->destroyEntityAt(m_EntityList.size() - 1);
+    m_NameIndex.clear();
 }
 
 // ----------------------------------------------------------------------------
 Entity& EntityManager::getEntity(Entity::ID entityID)
 {
-    for(auto& it : m_EntityList)
-        if(it.getID() == entityID)
-            return it;
+    const auto it = m_EntityIndex.find(entityID);
+    if(it != m_EntityIndex.end())
+        return m_EntityList[it->second];
     
     std::stringstream ss;
     ss << "[EntityManager::getEntity] Error: Entity ID " << entityID
@@ -100,22 +107,217 @@ Entity& EntityManager::getEntity(Entity::ID entityID)
     ONTOLOGY_ASSERT(false, InvalidEntityException, EntityManager::getEntity, ss.str());
 }
 
+// ----------------------------------------------------------------------------
+const std::vector<Entity::ID>& EntityManager::getEntityIDs(const char* name) const
+{
+    static const std::vector<Entity::ID> noEntities;
+
+    const auto it = m_NameIndex.find(std::string(name));
+    if(it == m_NameIndex.end())
+        return noEntities;
+    return it->second;
+}
+
+// ----------------------------------------------------------------------------
+SharedComponentPool& EntityManager::getSharedComponentPool() const
+{
+    return m_SharedComponentPool;
+}
+
 // ----------------------------------------------------------------------------
 const EntityManager::EntityList& EntityManager::getEntityList() const
 {
     return m_EntityList;
 }
 
+// ----------------------------------------------------------------------------
+void EntityManager::addComponentListener(EntityManagerListener* listener, const TypeVector& componentTypes)
+{
+    for(const auto& type : componentTypes)
+    {
+        std::vector<EntityManagerListener*>& listeners = m_ComponentListeners[type];
+        if(std::find(listeners.begin(), listeners.end(), listener) == listeners.end())
+            listeners.push_back(listener);
+    }
+}
+
+// ----------------------------------------------------------------------------
+void EntityManager::removeComponentListener(EntityManagerListener* listener)
+{
+    for(auto it = m_ComponentListeners.begin(); it != m_ComponentListeners.end(); )
+    {
+        std::vector<EntityManagerListener*>& listeners = it->second;
+        listeners.erase(std::remove(listeners.begin(), listeners.end(), listener), listeners.end());
+        if(listeners.empty())
+            it = m_ComponentListeners.erase(it);
+        else
+            ++it;
+    }
+}
+
+// ----------------------------------------------------------------------------
+void EntityManager::addEntityListener(Entity::ID entity, EntityListener* listener) const
+{
+    std::vector<EntityListener*>& listeners = m_EntityListeners[entity];
+    if(std::find(listeners.begin(), listeners.end(), listener) == listeners.end())
+        listeners.push_back(listener);
+}
+
+// ----------------------------------------------------------------------------
+void EntityManager::removeEntityListener(Entity::ID entity, EntityListener* listener) const
+{
+    const auto it = m_EntityListeners.find(entity);
+    if(it == m_EntityListeners.end())
+        return;
+    std::vector<EntityListener*>& listeners = it->second;
+    listeners.erase(std::remove(listeners.begin(), listeners.end(), listener), listeners.end());
+    if(listeners.empty())
+        m_EntityListeners.erase(it);
+
+    m_EntityEvents.erase(
+        std::remove_if(m_EntityEvents.begin(), m_EntityEvents.end(),
+            [entity, listener](const EntityEvent& event) {
+                return event.entity == entity && event.listener == listener;
+            }),
+        m_EntityEvents.end()
+    );
+}
+
+// ----------------------------------------------------------------------------
+void EntityManager::dispatchEntityEvents()
+{
+    if(m_EntityEvents.empty())
+        return;
+
+    // listeners may modify entities in turn, those events are delivered at
+    // the next sync point
+    std::vector<EntityEvent> events;
+    events.swap(m_EntityEvents);
+    for(const auto& event : events)
+    {
+        switch(event.type)
+        {
+            case EntityEvent::AddComponent:
+                event.listener->onAddComponent(event.entity, event.component.get());
+                break;
+            case EntityEvent::RemoveComponent:
+                event.listener->onRemoveComponent(event.entity, event.component.get());
+                break;
+            case EntityEvent::DestroyEntity:
+                event.listener->onDestroyEntity(event.entity);
+                break;
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+bool EntityManager::reorderEntities(std::size_t first, std::size_t last, const std::function<std::uint64_t(const Entity&)>& key)
+{
+    last = std::min(last, m_EntityList.size());
+    if(first + 1 >= last)
+        return false;
+
+    std::vector<std::pair<std::uint64_t, std::size_t>> order;
+    order.reserve(last - first);
+    for(std::size_t position = first; position != last; ++position)
+        order.emplace_back(key(m_EntityList[position]), position);
+    const auto byKey = [](const std::pair<std::uint64_t, std::size_t>& a, const std::pair<std::uint64_t, std::size_t>& b) {
+        return a.first < b.first;
+    };
+    if(std::is_sorted(order.begin(), order.end(), byKey))
+        return false;
+    std::stable_sort(order.begin(), order.end(), byKey);
+
+    // apply the permutation one cycle at a time, so every entity is swapped
+    // straight into place
+    std::vector<bool> placed(order.size(), false);
+    for(std::size_t start = 0; start != order.size(); ++start)
+    {
+        if(placed[start])
+            continue;
+        for(std::size_t i = start; ; )
+        {
+            placed[i] = true;
+            const std::size_t source = order[i].second - first;
+            if(source == start)
+                break;
+            m_EntityList[first + i].swap(m_EntityList[first + source]);
+            i = source;
+        }
+    }
+
+    // the entity that was at first+i is now where the sort put it. Systems
+    // fix up their references to the window and keep their own order.
+    std::vector<std::size_t> destinations(order.size());
+    for(std::size_t i = 0; i != order.size(); ++i)
+        destinations[order[i].second - first] = first + i;
+    for(std::size_t position = first; position != last; ++position)
+        m_EntityIndex[m_EntityList[position].getID()] = position;
+    this->event.dispatch(&EntityManagerListener::onEntitiesMoved, m_EntityList, first, destinations);
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+void EntityManager::queueEntityEvent(EntityEvent::Type type, const Entity& entity, const Component* component) const
+{
+    if(m_EntityListeners.empty() || m_RelocatingEntities || m_ReleasingDestroyedEntity)
+        return;
+    const auto it = m_EntityListeners.find(entity.getID());
+    if(it == m_EntityListeners.end())
+        return;
+
+    const std::shared_ptr<const Component> handle = entity.getComponentHandle(component);
+    for(const auto& listener : it->second)
+    {
+        EntityEvent event = {type, listener, entity.getID(), handle};
+        m_EntityEvents.push_back(std::move(event));
+    }
+}
+
+// ----------------------------------------------------------------------------
+void EntityManager::releaseEntityListeners(Entity::ID entity)
+{
+    const auto it = m_EntityListeners.find(entity);
+    if(it == m_EntityListeners.end())
+        return;
+    for(const auto& listener : it->second)
+    {
+        EntityEvent event = {EntityEvent::DestroyEntity, listener, entity, nullptr};
+        m_EntityEvents.push_back(std::move(event));
+    }
+    m_EntityListeners.erase(it);
+}
+
 // ----------------------------------------------------------------------------
 void EntityManager::informAddComponent(Entity& entity, const Component* component) const
 {
     this->event.dispatch(&EntityManagerListener::onAddComponent, entity, component);
+    this->queueEntityEvent(EntityEvent::AddComponent, entity, component);
+
+    // copies of entities destroyed while the list grows don't change any
+    // component
+    if(m_ComponentListeners.empty() || m_RelocatingEntities)
+        return;
+    const auto it = m_ComponentListeners.find(&typeid(*component));
+    if(it == m_ComponentListeners.end())
+        return;
+    for(const auto& listener : it->second)
+        listener->onAddComponent(entity, component);
 }
 
 // ----------------------------------------------------------------------------
 void EntityManager::informRemoveComponent(Entity& entity, const Component* component) const
 {
     this->event.dispatch(&EntityManagerListener::onRemoveComponent, entity, component);
+    this->queueEntityEvent(EntityEvent::RemoveComponent, entity, component);
+
+    if(m_ComponentListeners.empty() || m_RelocatingEntities)
+        return;
+    const auto it = m_ComponentListeners.find(&typeid(*component));
+    if(it == m_ComponentListeners.end())
+        return;
+    for(const auto& listener : it->second)
+        listener->onRemoveComponent(entity, component);
 }
 
 // ----------------------------------------------------------------------------
@@ -127,4 +329,30 @@ void EntityManager::handleEntityReallocation(bool force)
     m_EntityListCapacity = m_EntityList.capacity();
 }
 
+// ----------------------------------------------------------------------------
+void EntityManager::destroyEntityAt(std::size_t position)
+{
+    const Entity::ID entityID = m_EntityList[position].getID();
+    this->event.dispatch(&EntityManagerListener::onDestroyEntity, m_EntityList[position]);
+    m_EntityIndex.erase(entityID);
+
+    // fill the gap with the last entity, so at most one entity moves
+    const std::size_t last = m_EntityList.size() - 1;
+    std::vector<std::size_t> destinations;
+    if(position != last)
+    {
+        m_EntityList[position].swap(m_EntityList[last]);
+        m_EntityIndex[m_EntityList[position].getID()] = position;
+        destinations.push_back(position);
+    }
+
+    // the destroyed entity's components are released here, which entity
+    // listeners must not receive as individual removals
+    m_ReleasingDestroyedEntity = true;
+    m_EntityList.pop_back();
+    m_ReleasingDestroyedEntity = false;
+    this->releaseEntityListeners(entityID);
+    this->event.dispatch(&EntityManagerListener::onEntitiesMoved, m_EntityList, last, destinations);
+}
+
 } // namespace Ontology
@@ -34,4 +34,10 @@ void EntityManagerListener::onEntitiesReallocated(std::vector<Entity>&)
 {
 }
 
+// ----------------------------------------------------------------------------
+void EntityManagerListener::onEntitiesMoved(std::vector<Entity>& entityList, std::size_t, const std::vector<std::size_t>&)
+{
+    this->onEntitiesReallocated(entityList);
+}
+
 } // namespace Ontology
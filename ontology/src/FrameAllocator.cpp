@@ -0,0 +1,139 @@
+// ----------------------------------------------------------------------------
+// FrameAllocator.cpp
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <ontology/FrameAllocator.hpp>
+
+#include <algorithm>
+#include <atomic>
+
+namespace Ontology {
+
+// ----------------------------------------------------------------------------
+// remembers the arena a thread used last, so looking it up again doesn't
+// require locking. Allocators are identified by a unique ID rather than their
+// address, as a new allocator may be constructed where a destroyed one was.
+struct CachedArena
+{
+    std::uint64_t instanceID;
+    LinearArena*  arena;
+};
+static thread_local CachedArena t_CachedArena = {0, nullptr};
+static std::atomic<std::uint64_t> g_NextInstanceID(1);
+
+const std::size_t LinearArena::DefaultBlockSize;
+
+// ----------------------------------------------------------------------------
+LinearArena::LinearArena(std::size_t blockSize) :
+    m_BlockSize(blockSize ? blockSize : DefaultBlockSize),
+    m_Offset(0),
+    m_Used(0)
+{
+}
+
+// ----------------------------------------------------------------------------
+void* LinearArena::allocate(std::size_t size, std::size_t alignment)
+{
+    if(m_Blocks.size())
+    {
+        Block& block = m_Blocks.back();
+        const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block.data.get());
+        const std::size_t offset = ((base + m_Offset + alignment - 1) & ~(alignment - 1)) - base;
+        if(offset + size <= block.size)
+        {
+            m_Used += offset + size - m_Offset;
+            m_Offset = offset + size;
+            return block.data.get() + offset;
+        }
+    }
+
+    // grow geometrically so the number of blocks stays small until the
+    // next reset merges them
+    std::size_t blockSize = m_BlockSize;
+    if(m_Blocks.size())
+        blockSize = m_Blocks.back().size * 2;
+    this->addBlock(std::max(blockSize, size + alignment));
+    return this->allocate(size, alignment);
+}
+
+// ----------------------------------------------------------------------------
+void LinearArena::reset()
+{
+    if(m_Blocks.size() > 1)
+    {
+        const std::size_t capacity = this->getCapacity();
+        m_Blocks.clear();
+        this->addBlock(capacity);
+    }
+    m_Offset = 0;
+    m_Used = 0;
+}
+
+// ----------------------------------------------------------------------------
+std::size_t LinearArena::getUsed() const
+{
+    return m_Used;
+}
+
+// ----------------------------------------------------------------------------
+std::size_t LinearArena::getCapacity() const
+{
+    std::size_t capacity = 0;
+    for(const auto& block : m_Blocks)
+        capacity += block.size;
+    return capacity;
+}
+
+// ----------------------------------------------------------------------------
+void LinearArena::addBlock(std::size_t size)
+{
+    Block block;
+    block.data.reset(new char[size]);
+    block.size = size;
+    m_Blocks.push_back(std::move(block));
+    m_Offset = 0;
+}
+
+// ----------------------------------------------------------------------------
+FrameAllocator::FrameAllocator() :
+    m_InstanceID(g_NextInstanceID++)
+{
+}
+
+// ----------------------------------------------------------------------------
+LinearArena& FrameAllocator::local()
+{
+    if(t_CachedArena.instanceID == m_InstanceID)
+        return *t_CachedArena.arena;
+
+    std::lock_guard<std::mutex> guard(m_Mutex);
+    auto& arena = m_Arenas[std::this_thread::get_id()];
+    if(!arena)
+        arena.reset(new LinearArena);
+    t_CachedArena.instanceID = m_InstanceID;
+    t_CachedArena.arena = arena.get();
+    return *arena;
+}
+
+// ----------------------------------------------------------------------------
+void FrameAllocator::reset()
+{
+    std::lock_guard<std::mutex> guard(m_Mutex);
+    for(const auto& arena : m_Arenas)
+        arena.second->reset();
+}
+
+// ----------------------------------------------------------------------------
+std::size_t FrameAllocator::getUsed() const
+{
+    std::lock_guard<std::mutex> guard(m_Mutex);
+    std::size_t used = 0;
+    for(const auto& arena : m_Arenas)
+        used += arena.second->getUsed();
+    return used;
+}
+
+} // namespace Ontology
@@ -0,0 +1,242 @@
+// ----------------------------------------------------------------------------
+// Hierarchy.cpp
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <ontology/Hierarchy.hpp>
+#include <ontology/Entity.hpp>
+#include <ontology/Exception.hpp>
+#include <ontology/World.hxx>
+
+#include <string>
+
+namespace Ontology {
+
+const Entity::ID Hierarchy::InvalidID = std::numeric_limits<Entity::ID>::max();
+const std::size_t Hierarchy::InvalidIndex = std::numeric_limits<std::size_t>::max();
+
+// ----------------------------------------------------------------------------
+Hierarchy::Hierarchy(World* world) :
+    m_World(world),
+    m_LevelBegin(1, 0),
+    m_Dirty(false)
+{
+}
+
+// ----------------------------------------------------------------------------
+void Hierarchy::setParent(Entity::ID child, Entity::ID parent)
+{
+    for(Entity::ID ancestor = parent; ancestor != InvalidID; ancestor = this->getParent(ancestor))
+    {
+        if(ancestor != child)
+            continue;
+        const std::string message = std::string("Entity ") + std::to_string(parent) +
+            " can't become the parent of its ancestor " + std::to_string(child);
+        if(m_World)
+            m_World->log(message);
+        ONTOLOGY_ASSERT(false, InvalidParentException, Hierarchy::setParent, message)
+        return;
+    }
+
+    // adding nodes may reallocate, so look both up afterwards
+    this->findOrAdd(child);
+    this->findOrAdd(parent);
+    Node& childNode = m_Nodes[m_Index[child]];
+    Node& parentNode = m_Nodes[m_Index[parent]];
+
+    this->unlink(childNode);
+    childNode.parent = parent;
+    childNode.nextSibling = parentNode.firstChild;
+    parentNode.firstChild = child;
+    m_Dirty = true;
+}
+
+// ----------------------------------------------------------------------------
+void Hierarchy::removeParent(Entity::ID child)
+{
+    const auto it = m_Index.find(child);
+    if(it == m_Index.end())
+        return;
+    this->unlink(m_Nodes[it->second]);
+    m_Dirty = true;
+}
+
+// ----------------------------------------------------------------------------
+void Hierarchy::remove(Entity::ID entity)
+{
+    const auto it = m_Index.find(entity);
+    if(it == m_Index.end())
+        return;
+    const std::size_t position = it->second;
+
+    // orphaned children become roots
+    Node& node = m_Nodes[position];
+    for(Entity::ID child = node.firstChild; child != InvalidID; )
+    {
+        Node& childNode = m_Nodes[m_Index[child]];
+        child = childNode.nextSibling;
+        childNode.parent = InvalidID;
+        childNode.nextSibling = InvalidID;
+    }
+    node.firstChild = InvalidID;
+    this->unlink(node);
+
+    // the order is rebuilt anyway, so fill the gap with the last node
+    m_Index.erase(it);
+    if(position != m_Nodes.size() - 1)
+    {
+        m_Nodes[position] = m_Nodes.back();
+        m_Index[m_Nodes[position].entity] = position;
+    }
+    m_Nodes.pop_back();
+    m_Dirty = true;
+}
+
+// ----------------------------------------------------------------------------
+bool Hierarchy::contains(Entity::ID entity) const
+{
+    return m_Index.find(entity) != m_Index.end();
+}
+
+// ----------------------------------------------------------------------------
+Entity::ID Hierarchy::getParent(Entity::ID entity) const
+{
+    const auto it = m_Index.find(entity);
+    if(it == m_Index.end())
+        return InvalidID;
+    return m_Nodes[it->second].parent;
+}
+
+// ----------------------------------------------------------------------------
+std::vector<Entity::ID> Hierarchy::getChildren(Entity::ID entity) const
+{
+    std::vector<Entity::ID> children;
+    const auto it = m_Index.find(entity);
+    if(it == m_Index.end())
+        return children;
+    for(Entity::ID child = m_Nodes[it->second].firstChild; child != InvalidID; child = m_Nodes[m_Index[child]].nextSibling)
+        children.push_back(child);
+    return children;
+}
+
+// ----------------------------------------------------------------------------
+std::size_t Hierarchy::getIndex(Entity::ID entity) const
+{
+    this->sort();
+    const auto it = m_Index.find(entity);
+    if(it == m_Index.end())
+        return InvalidIndex;
+    return it->second;
+}
+
+// ----------------------------------------------------------------------------
+const std::vector<Hierarchy::Node>& Hierarchy::getNodes() const
+{
+    this->sort();
+    return m_Nodes;
+}
+
+// ----------------------------------------------------------------------------
+std::size_t Hierarchy::getLevelCount() const
+{
+    this->sort();
+    return m_LevelBegin.size() - 1;
+}
+
+// ----------------------------------------------------------------------------
+std::size_t Hierarchy::getLevelBegin(std::size_t depth) const
+{
+    this->sort();
+    if(depth >= m_LevelBegin.size())
+        return m_Nodes.size();
+    return m_LevelBegin[depth];
+}
+
+// ----------------------------------------------------------------------------
+void Hierarchy::onDestroyEntity(Entity& entity)
+{
+    this->remove(entity.getID());
+}
+
+// ----------------------------------------------------------------------------
+Hierarchy::Node& Hierarchy::findOrAdd(Entity::ID entity)
+{
+    const auto it = m_Index.find(entity);
+    if(it != m_Index.end())
+        return m_Nodes[it->second];
+
+    Node node = {entity, InvalidID, InvalidID, InvalidID, InvalidIndex, 0};
+    m_Index[entity] = m_Nodes.size();
+    m_Nodes.push_back(node);
+    m_Dirty = true;
+    return m_Nodes.back();
+}
+
+// ----------------------------------------------------------------------------
+void Hierarchy::unlink(Node& node)
+{
+    if(node.parent == InvalidID)
+        return;
+
+    Node& parent = m_Nodes[m_Index[node.parent]];
+    if(parent.firstChild == node.entity)
+        parent.firstChild = node.nextSibling;
+    else
+    {
+        Node* sibling = &m_Nodes[m_Index[parent.firstChild]];
+        while(sibling->nextSibling != node.entity)
+            sibling = &m_Nodes[m_Index[sibling->nextSibling]];
+        sibling->nextSibling = node.nextSibling;
+    }
+    node.parent = InvalidID;
+    node.nextSibling = InvalidID;
+}
+
+// ----------------------------------------------------------------------------
+void Hierarchy::sort() const
+{
+    if(!m_Dirty)
+        return;
+
+    // breadth-first traversal starting with all roots. Appending children
+    // while iterating the output makes it its own queue.
+    std::vector<Node> sorted;
+    sorted.reserve(m_Nodes.size());
+    for(const auto& node : m_Nodes)
+    {
+        if(node.parent != InvalidID)
+            continue;
+        sorted.push_back(node);
+        sorted.back().parentIndex = InvalidIndex;
+        sorted.back().depth = 0;
+    }
+
+    m_LevelBegin.assign(1, 0);
+    for(std::size_t index = 0; index != sorted.size(); ++index)
+    {
+        const std::size_t depth = sorted[index].depth;
+        if(depth == m_LevelBegin.size())
+            m_LevelBegin.push_back(index);
+
+        for(Entity::ID child = sorted[index].firstChild; child != InvalidID; )
+        {
+            Node node = m_Nodes[m_Index[child]];
+            node.parentIndex = index;
+            node.depth = depth + 1;
+            sorted.push_back(node);
+            child = node.nextSibling;
+        }
+    }
+    m_LevelBegin.push_back(sorted.size());
+    if(sorted.empty())
+        m_LevelBegin.assign(1, 0);
+
+    m_Nodes.swap(sorted);
+    for(std::size_t index = 0; index != m_Nodes.size(); ++index)
+        m_Index[m_Nodes[index].entity] = index;
+    m_Dirty = false;
+}
+
+} // namespace Ontology
@@ -0,0 +1,229 @@
+// ----------------------------------------------------------------------------
+// SpatialIndex.cpp
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <ontology/SpatialIndex.hpp>
+#include <ontology/Entity.hpp>
+#include <ontology/EntityManager.hpp>
+#include <ontology/World.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Ontology {
+
+// ----------------------------------------------------------------------------
+SpatialIndex::SpatialIndex(const std::type_info* positionType, float cellSize, PositionFunction position) :
+    m_PositionType(positionType),
+    m_CellSize(cellSize > 0.0f ? cellSize : 1.0f),
+    m_Position(std::move(position)),
+    m_BuildTick(0),
+    m_Built(false),
+    m_ReorderBudget(0),
+    m_ReorderCursor(0),
+    m_ReorderShifted(false)
+{
+}
+
+// ----------------------------------------------------------------------------
+std::vector<Entity::ID> SpatialIndex::queryRadius(const World& world, Point center, float radius)
+{
+    // hold the lock until the query is done, so a concurrent query can't
+    // rebuild the grid under it
+    std::lock_guard<std::mutex> guard(m_Mutex);
+    this->refreshLocked(world);
+
+    std::vector<Entity::ID> result;
+    const float radiusSquared = radius * radius;
+    this->forEachInBox(
+        Point(center.x - radius, center.y - radius, center.z - radius),
+        Point(center.x + radius, center.y + radius, center.z + radius),
+        [&](const Entry& entry) {
+            const float dx = entry.position.x - center.x;
+            const float dy = entry.position.y - center.y;
+            const float dz = entry.position.z - center.z;
+            if(dx*dx + dy*dy + dz*dz <= radiusSquared)
+                result.push_back(entry.entity);
+        }
+    );
+    return result;
+}
+
+// ----------------------------------------------------------------------------
+std::vector<Entity::ID> SpatialIndex::queryAABB(const World& world, Point min, Point max)
+{
+    std::lock_guard<std::mutex> guard(m_Mutex);
+    this->refreshLocked(world);
+
+    std::vector<Entity::ID> result;
+    this->forEachInBox(min, max, [&result](const Entry& entry) {
+        result.push_back(entry.entity);
+    });
+    return result;
+}
+
+// ----------------------------------------------------------------------------
+void SpatialIndex::refresh(const World& world)
+{
+    std::lock_guard<std::mutex> guard(m_Mutex);
+    this->refreshLocked(world);
+}
+
+// ----------------------------------------------------------------------------
+void SpatialIndex::refreshLocked(const World& world)
+{
+    const std::uint64_t changeTick = world.getChangeTick(m_PositionType);
+    if(m_Built && changeTick == m_BuildTick)
+        return;
+
+    m_Entries.clear();
+    for(const auto& entity : world.getEntityManager().getEntityList())
+    {
+        Entry entry;
+        if(!m_Position(entity, entry.position))
+            continue;
+        entry.entity = entity.getID();
+        entry.cell = getCellKey(
+            this->getCellCoordinate(entry.position.x),
+            this->getCellCoordinate(entry.position.y),
+            this->getCellCoordinate(entry.position.z)
+        );
+        m_Entries.push_back(entry);
+    }
+
+    // entries of a cell are stored contiguously, so a cell is a range
+    std::sort(m_Entries.begin(), m_Entries.end(), [](const Entry& a, const Entry& b) {
+        return a.cell < b.cell;
+    });
+    m_Cells.clear();
+    for(std::size_t begin = 0; begin != m_Entries.size(); )
+    {
+        std::size_t end = begin + 1;
+        while(end != m_Entries.size() && m_Entries[end].cell == m_Entries[begin].cell)
+            ++end;
+        m_Cells[m_Entries[begin].cell] = std::make_pair(begin, end);
+        begin = end;
+    }
+
+    m_BuildTick = changeTick;
+    m_Built = true;
+}
+
+// ----------------------------------------------------------------------------
+std::size_t SpatialIndex::size() const
+{
+    return m_Entries.size();
+}
+
+// ----------------------------------------------------------------------------
+SpatialIndex& SpatialIndex::setReorderBudget(std::size_t entitiesPerUpdate)
+{
+    m_ReorderBudget = entitiesPerUpdate;
+    return *this;
+}
+
+// ----------------------------------------------------------------------------
+void SpatialIndex::reorderEntities(EntityManager& entityManager)
+{
+    const std::size_t entityCount = entityManager.getEntityList().size();
+    if(m_ReorderBudget == 0 || entityCount < 2)
+        return;
+
+    const std::size_t window = std::min(m_ReorderBudget, entityCount);
+    if(m_ReorderCursor >= entityCount)
+    {
+        m_ReorderShifted = !m_ReorderShifted;
+        m_ReorderCursor = (m_ReorderShifted ? window / 2 : 0);
+    }
+
+    const std::size_t first = m_ReorderCursor;
+    m_ReorderCursor = std::min(first + window, entityCount);
+    entityManager.reorderEntities(first, m_ReorderCursor, [this](const Entity& entity) {
+        return this->getMortonCode(entity);
+    });
+}
+
+// ----------------------------------------------------------------------------
+std::int64_t SpatialIndex::getCellCoordinate(float position) const
+{
+    return static_cast<std::int64_t>(std::floor(position / m_CellSize));
+}
+
+// ----------------------------------------------------------------------------
+std::uint64_t SpatialIndex::getCellKey(std::int64_t x, std::int64_t y, std::int64_t z)
+{
+    // 21 bits per axis. Far apart cells may share a key, which only costs
+    // the time of testing their entries.
+    const std::uint64_t mask = (1 << 21) - 1;
+    return ((static_cast<std::uint64_t>(x) & mask) << 42) |
+           ((static_cast<std::uint64_t>(y) & mask) << 21) |
+            (static_cast<std::uint64_t>(z) & mask);
+}
+
+// ----------------------------------------------------------------------------
+std::uint64_t SpatialIndex::getMortonCode(const Entity& entity) const
+{
+    Point position;
+    if(!m_Position(entity, position))
+        return std::numeric_limits<std::uint64_t>::max();
+
+    // offset to make coordinates positive, then spread each to every third bit
+    const auto spread = [this](float position) {
+        const std::int64_t offset = std::int64_t(1) << 20;
+        const std::int64_t coordinate = this->getCellCoordinate(position) + offset;
+        std::uint64_t x = static_cast<std::uint64_t>(std::max<std::int64_t>(0, std::min<std::int64_t>(coordinate, 2 * offset - 1)));
+        x = (x | (x << 32)) & 0x1f00000000ffffULL;
+        x = (x | (x << 16)) & 0x1f0000ff0000ffULL;
+        x = (x | (x << 8))  & 0x100f00f00f00f00fULL;
+        x = (x | (x << 4))  & 0x10c30c30c30c30c3ULL;
+        x = (x | (x << 2))  & 0x1249249249249249ULL;
+        return x;
+    };
+    return (spread(position.x) << 2) | (spread(position.y) << 1) | spread(position.z);
+}
+
+// ----------------------------------------------------------------------------
+void SpatialIndex::forEachInBox(Point min, Point max, const std::function<void(const Entry&)>& function) const
+{
+    const auto inBox = [&min, &max](const Point& point) {
+        return point.x >= min.x && point.x <= max.x &&
+               point.y >= min.y && point.y <= max.y &&
+               point.z >= min.z && point.z <= max.z;
+    };
+
+    const std::int64_t minX = this->getCellCoordinate(min.x), maxX = this->getCellCoordinate(max.x);
+    const std::int64_t minY = this->getCellCoordinate(min.y), maxY = this->getCellCoordinate(max.y);
+    const std::int64_t minZ = this->getCellCoordinate(min.z), maxZ = this->getCellCoordinate(max.z);
+
+    // boxes covering more cells than there are entries are cheaper to test
+    // entry by entry. Boxes wider than 2^21 cells would visit cells sharing
+    // a key twice.
+    const std::int64_t maxWidth = (1 << 21) - 1;
+    const double cellCount = double(maxX - minX + 1) * double(maxY - minY + 1) * double(maxZ - minZ + 1);
+    if(cellCount > double(m_Entries.size()) || cellCount > double(m_Cells.size()) * 4 ||
+       maxX - minX >= maxWidth || maxY - minY >= maxWidth || maxZ - minZ >= maxWidth)
+    {
+        for(const auto& entry : m_Entries)
+            if(inBox(entry.position))
+                function(entry);
+        return;
+    }
+
+    for(std::int64_t x = minX; x <= maxX; ++x)
+        for(std::int64_t y = minY; y <= maxY; ++y)
+            for(std::int64_t z = minZ; z <= maxZ; ++z)
+            {
+                const auto it = m_Cells.find(getCellKey(x, y, z));
+                if(it == m_Cells.end())
+                    continue;
+                for(std::size_t i = it->second.first; i != it->second.second; ++i)
+                    if(inBox(m_Entries[i].position))
+                        function(m_Entries[i]);
+            }
+}
+
+} // namespace Ontology
@@ -5,9 +5,18 @@
 // ----------------------------------------------------------------------------
 // include files
 
+#include <ontology/CommandBuffer.hpp>
+#include <ontology/Reduction.hpp>
 #include <ontology/World.hpp>
 #include <ontology/Entity.hpp>
+#include <ontology/EntityManager.hpp>
 #include <ontology/System.hpp>
+#include <ontology/SystemGroup.hpp>
+#include <ontology/ThreadPool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
 
 #ifdef ONTOLOGY_THREAD
 #   include <boost/bind.hpp>
@@ -17,6 +26,29 @@
 
 namespace Ontology {
 
+// ----------------------------------------------------------------------------
+// Below this estimated time per update, waking up other threads costs more
+// than it saves.
+static const double ParallelThresholdNanoseconds = 100000.0;
+
+// Chunks should take at least this long to be worth handing to a thread.
+static const double ChunkCostNanoseconds = 25000.0;
+
+// More chunks per thread than this only add overhead.
+static const std::size_t MaxChunksPerThread = 8;
+
+// Chunk size of deterministic worlds, unless a system chooses its own.
+static const std::size_t DeterministicGrainSize = 64;
+
+// The chunk of entities the current thread is processing, and for which
+// system. Used to find the chunk's command buffer.
+struct CurrentChunk
+{
+    const System* system;
+    std::size_t chunk;
+};
+static thread_local CurrentChunk t_CurrentChunk = {nullptr, 0};
+
 // ----------------------------------------------------------------------------
 /*!
  * @brief Gets the number of cores on this machine.
@@ -60,8 +92,22 @@ int getNumberOfCores() {
 // ----------------------------------------------------------------------------
 System::System() :
     world(nullptr),
+    m_TypeID(0),
+    m_Group(nullptr),
+    m_GroupKey(nullptr),
+    m_EntityBudget(0),
+    m_TimeBudget(0),
+    m_SliceCursor(0),
+    m_ExecutionPolicy(ExecutionPolicy::Serial),
+    m_GrainSize(0),
+    m_CostPerEntity(0.0),
+    m_LastRunTick(0),
+    m_SkipWhenEmpty(false),
+    m_EntityListChanged(false),
+    m_EntityListStale(false),
     m_Initialised(false)
 {
+    m_CommandBuffers.emplace_back(new CommandBuffer);
 }
 
 // ----------------------------------------------------------------------------
@@ -75,13 +121,26 @@ bool System::isInitialised() const
     return m_Initialised;
 }
 
+// ----------------------------------------------------------------------------
+const std::string& System::getName() const
+{
+    return m_Name;
+}
+
+// ----------------------------------------------------------------------------
+void System::setName(std::string name)
+{
+    m_Name = name;
+}
+
 // ----------------------------------------------------------------------------
 void System::initialiseGuard(std::string systemName)
 {
     if(m_Initialised)
         return;
-    std::cout << "[" << systemName << "] initialising..." << std::endl;
+    world->log("[" + systemName + "] initialising...");
     this->initialise();
+    m_Initialised = true;
 }
 
 // ----------------------------------------------------------------------------
@@ -90,33 +149,175 @@ const TypeSet& System::getSupportedComponents() const
     return m_SupportedComponents;
 }
 
+// ----------------------------------------------------------------------------
+const TypeSet& System::getSupportedDataComponents() const
+{
+    return m_SupportedDataComponents;
+}
+
+// ----------------------------------------------------------------------------
+const std::vector<TypeID>& System::getSupportedTags() const
+{
+    return m_SupportedTags;
+}
+
 // ----------------------------------------------------------------------------
 const TypeSet& System::getDependingSystems() const
 {
     return m_DependingSystems;
 }
 
+// ----------------------------------------------------------------------------
+const std::vector<TypeID>& System::getDependingSystemIDs() const
+{
+    return m_DependingSystemIDs;
+}
+
+// ----------------------------------------------------------------------------
+System& System::inGroup(SystemGroup& group)
+{
+    if(m_Group)
+        m_Group->invalidate();
+    m_Group = &group;
+    m_Group->invalidate();
+    return *this;
+}
+
+// ----------------------------------------------------------------------------
+SystemGroup* System::getGroup() const
+{
+    return m_Group;
+}
+
+// ----------------------------------------------------------------------------
+System& System::setEntityBudget(std::size_t count)
+{
+    m_EntityBudget = count;
+    return *this;
+}
+
+// ----------------------------------------------------------------------------
+System& System::setTimeBudget(std::chrono::microseconds budget)
+{
+    m_TimeBudget = budget;
+    return *this;
+}
+
+// ----------------------------------------------------------------------------
+System& System::setExecutionPolicy(ExecutionPolicy policy, std::size_t grainSize)
+{
+    m_ExecutionPolicy = policy;
+    m_GrainSize = grainSize;
+    return *this;
+}
+
+// ----------------------------------------------------------------------------
+double System::getCostPerEntity() const
+{
+    return m_CostPerEntity;
+}
+
+// ----------------------------------------------------------------------------
+System& System::runIf(std::function<bool(World&)> predicate)
+{
+    m_RunCondition = std::move(predicate);
+    return *this;
+}
+
+// ----------------------------------------------------------------------------
+System& System::skipsWhenEmpty(bool skip)
+{
+    m_SkipWhenEmpty = skip;
+    return *this;
+}
+
+// ----------------------------------------------------------------------------
+bool System::shouldRun() const
+{
+    if(m_SkipWhenEmpty && m_EntityList.empty())
+        return false;
+
+    if(m_ChangeFilter.size())
+    {
+        bool changed = false;
+        for(const auto& type : m_ChangeFilter)
+            if(world->getChangeTick(type) > m_LastRunTick)
+            {
+                changed = true;
+                break;
+            }
+        if(!changed)
+            return false;
+    }
+
+    // evaluated last, as the predicate may be the most expensive criterion
+    if(m_RunCondition && !m_RunCondition(*world))
+        return false;
+
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+const TypeSet& System::getReadTypes() const
+{
+    return m_ReadTypes;
+}
+
+// ----------------------------------------------------------------------------
+const TypeSet& System::getWriteTypes() const
+{
+    return m_WriteTypes;
+}
+
+// ----------------------------------------------------------------------------
+void System::declareAccess(const TypeSet& readTypes, const TypeSet& writeTypes)
+{
+    m_ReadTypes = readTypes;
+    m_WriteTypes = writeTypes;
+}
+
 // ----------------------------------------------------------------------------
 void System::setWorld(World* world)
 {
     this->world = world;
 }
 
+// ----------------------------------------------------------------------------
+void System::setTypeID(TypeID typeID)
+{
+    m_TypeID = typeID;
+}
+
+// ----------------------------------------------------------------------------
+TypeID System::getTypeID() const
+{
+    return m_TypeID;
+}
+
 // ----------------------------------------------------------------------------
 void System::informEntityUpdate(Entity& entity)
 {
     for(auto it = m_EntityList.begin(); it != m_EntityList.end(); ++it)
         if(&it->get() == &entity)
         {
+            m_EntityListStale = true;
             if(entity.supportsSystem(*this))
+            {
+                // a shared component may have changed
+                m_EntityListChanged = true;
                 return;
+            }
             // entity is no longer supported by this system
             m_EntityList.erase(it);
             return;
         }
 
     if(entity.supportsSystem(*this))
+    {
         m_EntityList.push_back(entity);
+        m_EntityListChanged = true;
+        m_EntityListStale = true;
+    }
 }
 
 // ----------------------------------------------------------------------------
@@ -126,6 +327,7 @@ void System::informDestroyedEntity(const Entity& entity)
         if(&it->get() == &entity)
         {
             m_EntityList.erase(it);
+            m_EntityListStale = true;
             return;
         }
 }
@@ -136,6 +338,103 @@ void System::informEntitiesReallocated(std::vector<Entity>& entityList)
     m_EntityList.clear();
     for(auto& it : entityList)
         this->informEntityUpdate(it);
+    m_EntityListChanged = true;
+    m_EntityListStale = true;
+}
+
+// ----------------------------------------------------------------------------
+void System::collectEntities(EntityManager& entityManager)
+{
+    m_EntityList.clear();
+    for(const auto& entity : entityManager.getEntityList())
+        if(entity.supportsSystem(*this))
+            m_EntityList.push_back(entityManager.getEntity(entity.getID()));
+    m_EntityListChanged = true;
+    m_EntityListStale = true;
+}
+
+// ----------------------------------------------------------------------------
+void System::informEntitiesMoved(std::vector<Entity>& entityList, std::size_t first, const std::vector<std::size_t>& destinations)
+{
+    if(destinations.empty())
+        return;
+    m_EntityListStale = true;
+    for(auto& entity : m_EntityList)
+    {
+        const std::size_t offset = static_cast<std::size_t>(&entity.get() - entityList.data()) - first;
+        if(offset < destinations.size())
+            entity = entityList[destinations[offset]];
+    }
+}
+
+// ----------------------------------------------------------------------------
+void System::groupEntities()
+{
+    const GroupKeyFunction groupKey = m_GroupKey;
+    std::stable_sort(m_EntityList.begin(), m_EntityList.end(),
+        [groupKey](const Entity& a, const Entity& b) {
+            return std::less<const void*>()(groupKey(a), groupKey(b));
+        }
+    );
+    m_EntityListChanged = false;
+    m_EntityListStale = true;
+}
+
+// ----------------------------------------------------------------------------
+void System::sortEntities()
+{
+    if(m_Sorter->sort(m_EntityList))
+        m_EntityListStale = true;
+    m_EntityListChanged = false;
+}
+
+// ----------------------------------------------------------------------------
+bool System::processEntitySlice()
+{
+    const std::size_t entityCount = m_EntityList.size();
+
+    // the entity list may have shrunk since the last update
+    if(m_SliceCursor >= entityCount)
+        m_SliceCursor = 0;
+
+    // reductions accumulate over a whole pass through the entity list, which
+    // may take several updates
+    this->prepareChunks(1, m_SliceCursor == 0);
+    if(entityCount == 0)
+    {
+        this->mergeReductions();
+        return true;
+    }
+
+    std::size_t remaining = entityCount;
+    if(m_EntityBudget)
+        remaining = std::min(remaining, m_EntityBudget);
+
+    bool wrapped = false;
+    const auto start = std::chrono::steady_clock::now();
+    while(remaining)
+    {
+        // process up to the end of the list, or a single entity if the time
+        // budget needs to be checked
+        std::size_t batch = std::min(remaining, entityCount - m_SliceCursor);
+        if(m_TimeBudget.count())
+            batch = 1;
+
+        const auto first = m_EntityList.begin() + m_SliceCursor;
+        this->processEntities(first, first + batch);
+        m_SliceCursor = (m_SliceCursor + batch) % entityCount;
+        remaining -= batch;
+        if(m_SliceCursor == 0)
+        {
+            wrapped = true;
+            this->mergeReductions();
+            this->prepareChunks(1);
+        }
+
+        if(m_TimeBudget.count() && std::chrono::steady_clock::now() - start >= m_TimeBudget)
+            break;
+    }
+    return wrapped;
 }
 
 // ----------------------------------------------------------------------------
@@ -164,11 +463,231 @@ void System::waitForNotify()
 #endif
 
 // ----------------------------------------------------------------------------
-void System::update()
+void System::processEntityList()
+{
+    const std::size_t entityCount = m_EntityList.size();
+    if(entityCount == 0)
+    {
+        this->prepareChunks(1);
+        this->processEntities(m_EntityList.begin(), m_EntityList.end());
+        return;
+    }
+
+    const std::size_t grainSize = this->chooseGrainSize(entityCount);
+    if(grainSize == 0 || grainSize >= entityCount)
+    {
+        this->prepareChunks(1);
+        const auto start = std::chrono::steady_clock::now();
+        this->processChunk(0, entityCount, 0);
+        this->recordCost(std::chrono::steady_clock::now() - start, entityCount);
+        return;
+    }
+
+    const std::size_t chunkCount = (entityCount + grainSize - 1) / grainSize;
+    this->prepareChunks(chunkCount);
+
+    // deterministic worlds partition serial systems into chunks as well, so
+    // their command buffers are applied in the same order
+    if(m_ExecutionPolicy == ExecutionPolicy::Serial || world->getThreadPool().getThreadCount() < 2)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for(std::size_t first = 0; first < entityCount; first += grainSize)
+            this->processChunk(first, std::min(first + grainSize, entityCount), first / grainSize);
+        this->recordCost(std::chrono::steady_clock::now() - start, entityCount);
+        return;
+    }
+
+    // sum up the time spent in every chunk rather than measuring the wall
+    // time, so the cost per entity doesn't depend on the number of threads
+    std::atomic<std::chrono::nanoseconds::rep> duration(0);
+    world->getThreadPool().parallelFor(entityCount, grainSize,
+        [this, grainSize, &duration](std::size_t first, std::size_t last) {
+            const auto start = std::chrono::steady_clock::now();
+            this->processChunk(first, last, first / grainSize);
+            duration += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+        }
+    );
+    this->recordCost(std::chrono::nanoseconds(duration.load()), entityCount);
+}
+
+// ----------------------------------------------------------------------------
+void System::processChunk(std::size_t first, std::size_t last, std::size_t chunk)
+{
+    // restores the previous chunk even if processing throws, in case this
+    // system is processed from within another system's chunk
+    struct ChunkGuard
+    {
+        ChunkGuard(const System* system, std::size_t chunk) : previous(t_CurrentChunk)
+        {
+            t_CurrentChunk.system = system;
+            t_CurrentChunk.chunk = chunk;
+        }
+        ~ChunkGuard() { t_CurrentChunk = previous; }
+        CurrentChunk previous;
+    } guard(this, chunk);
+
+    this->processEntities(m_EntityList.begin() + first, m_EntityList.begin() + last);
+}
+
+// ----------------------------------------------------------------------------
+std::size_t System::chooseGrainSize(std::size_t entityCount) const
+{
+    if(world == nullptr)
+        return 0;
+
+    // fixed partitioning, independent of threads and measurements
+    if(world->isDeterministic())
+        return m_GrainSize ? m_GrainSize : DeterministicGrainSize;
+
+    if(m_ExecutionPolicy == ExecutionPolicy::Serial)
+        return 0;
+
+    const std::size_t threadCount = world->getThreadPool().getThreadCount();
+    if(threadCount < 2)
+        return 0;
+    const std::size_t minGrainSize = (entityCount + threadCount * MaxChunksPerThread - 1) / (threadCount * MaxChunksPerThread);
+
+    if(m_ExecutionPolicy == ExecutionPolicy::Parallel)
+    {
+        if(m_GrainSize)
+            return m_GrainSize;
+        return (entityCount + threadCount - 1) / threadCount;
+    }
+
+    // the first update is processed serially to measure the cost
+    if(m_CostPerEntity <= 0.0 || m_CostPerEntity * entityCount < ParallelThresholdNanoseconds)
+        return 0;
+    if(m_GrainSize)
+        return m_GrainSize;
+    const std::size_t grainSize = static_cast<std::size_t>(ChunkCostNanoseconds / m_CostPerEntity) + 1;
+    return std::max(grainSize, minGrainSize);
+}
+
+// ----------------------------------------------------------------------------
+CommandBuffer& System::getCommandBuffer()
 {
-    #pragma omp parallel for
-    for(auto it = m_EntityList.begin(); it < m_EntityList.end(); ++it)
+    return *m_CommandBuffers[this->getCurrentChunk()];
+}
+
+// ----------------------------------------------------------------------------
+std::size_t System::getCurrentChunk() const
+{
+    if(t_CurrentChunk.system != this)
+        return 0;
+    return t_CurrentChunk.chunk;
+}
+
+// ----------------------------------------------------------------------------
+void System::addReduction(ReductionBase* reduction)
+{
+    m_Reductions.push_back(reduction);
+}
+
+// ----------------------------------------------------------------------------
+void System::removeReduction(ReductionBase* reduction)
+{
+    m_Reductions.erase(std::remove(m_Reductions.begin(), m_Reductions.end(), reduction), m_Reductions.end());
+}
+
+// ----------------------------------------------------------------------------
+void System::prepareChunks(std::size_t chunkCount, bool resetReductions)
+{
+    while(m_CommandBuffers.size() < chunkCount)
+        m_CommandBuffers.emplace_back(new CommandBuffer);
+    if(resetReductions)
+        for(const auto& reduction : m_Reductions)
+            reduction->reset(chunkCount);
+}
+
+// ----------------------------------------------------------------------------
+void System::mergeReductions()
+{
+    for(const auto& reduction : m_Reductions)
+        reduction->merge();
+}
+
+// ----------------------------------------------------------------------------
+void System::applyCommandBuffers()
+{
+    for(const auto& commandBuffer : m_CommandBuffers)
+        if(commandBuffer->size())
+            commandBuffer->apply(*world);
+}
+
+// ----------------------------------------------------------------------------
+void System::recordCost(std::chrono::nanoseconds duration, std::size_t entityCount)
+{
+    // exponential moving average, so the cost adapts to changes over time
+    // without single slow frames flipping the decision
+    const double sample = static_cast<double>(duration.count()) / entityCount;
+    if(m_CostPerEntity <= 0.0)
+        m_CostPerEntity = sample;
+    else
+        m_CostPerEntity += (sample - m_CostPerEntity) * 0.2;
+}
+
+// ----------------------------------------------------------------------------
+void System::processEntities(EntityList::iterator first, EntityList::iterator last)
+{
+    for(auto it = first; it != last; ++it)
         this->processEntity(*it);
+}
+
+// ----------------------------------------------------------------------------
+void System::onEntityListChanged(EntityList&)
+{
+}
+
+// ----------------------------------------------------------------------------
+void System::update()
+{
+    // budgeted systems only re-sort between passes, as the slice cursor
+    // indexes the order of the current pass
+    if(m_Sorter)
+    {
+        if(m_SliceCursor == 0)
+            this->sortEntities();
+    }
+    else if(m_GroupKey && m_EntityListChanged)
+        this->groupEntities();
+
+    if(m_EntityListStale)
+    {
+        this->onEntityListChanged(m_EntityList);
+        m_EntityListStale = false;
+    }
+
+    // slices process at least one entity if there are any
+    const bool processesEntities = !m_EntityList.empty();
+
+    // a budgeted system only caught up with changes once its slices wrapped
+    // around the entity list
+    bool caughtUp = true;
+    if(m_EntityBudget || m_TimeBudget.count())
+        caughtUp = this->processEntitySlice();
+    else
+    {
+        this->processEntityList();
+        this->mergeReductions();
+    }
+
+    if(world)
+    {
+        this->applyCommandBuffers();
+        world->flushEvents();
+        world->getEntityManager().dispatchEntityEvents();
+    }
+
+    // the system's own writes don't cause it to run again
+    if(world)
+    {
+        if(processesEntities)
+            for(const auto& type : m_WriteTypes)
+                world->markChanged(type);
+        if(caughtUp)
+            m_LastRunTick = world->getChangeTick();
+    }
     return;
 /* TODO get this reviewed
     // restart iterator, threads will increment this whenever they pick up
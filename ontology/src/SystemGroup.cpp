@@ -0,0 +1,142 @@
+// ----------------------------------------------------------------------------
+// SystemGroup.cpp
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <ontology/SystemGroup.hpp>
+#include <ontology/System.hpp>
+#include <ontology/World.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace Ontology {
+
+// ----------------------------------------------------------------------------
+SystemGroup::SystemGroup(std::string name) :
+    m_Name(name),
+    m_RecentDeltaSum(0.0f),
+    m_Timestep(0.0f),
+    m_Accumulator(0.0f),
+    m_MaxSteps(0),
+    m_TickDivisor(1),
+    m_Frame(0),
+    m_Spread(false),
+    m_Invalidated(false)
+{
+}
+
+// ----------------------------------------------------------------------------
+const std::string& SystemGroup::getName() const
+{
+    return m_Name;
+}
+
+// ----------------------------------------------------------------------------
+SystemGroup& SystemGroup::setFixedTimestep(float timestep, unsigned int maxSteps)
+{
+    m_Timestep = timestep;
+    m_MaxSteps = maxSteps;
+    m_Accumulator = 0.0f;
+    m_TickDivisor = 1;
+    return *this;
+}
+
+// ----------------------------------------------------------------------------
+SystemGroup& SystemGroup::setTickDivisor(unsigned int divisor, bool spread)
+{
+    m_TickDivisor = std::max(divisor, 1u);
+    m_Spread = spread;
+    m_Timestep = 0.0f;
+    m_RecentDeltas.assign(m_TickDivisor, 0.0f);
+    m_RecentDeltaSum = 0.0f;
+    m_Frame = 0;
+    return *this;
+}
+
+// ----------------------------------------------------------------------------
+float SystemGroup::getInterpolation() const
+{
+    if(m_Timestep <= 0.0f)
+        return 0.0f;
+    return m_Accumulator / m_Timestep;
+}
+
+// ----------------------------------------------------------------------------
+void SystemGroup::update(World* world)
+{
+    const float frameDelta = world->getDeltaTime();
+
+    if(m_Timestep > 0.0f)
+    {
+        m_Accumulator += frameDelta;
+        unsigned int steps = static_cast<unsigned int>(m_Accumulator / m_Timestep);
+        if(steps > m_MaxSteps)
+        {
+            // drop the time that can't be caught up with
+            steps = m_MaxSteps;
+            m_Accumulator = std::fmod(m_Accumulator, m_Timestep);
+        }
+        else
+            m_Accumulator -= steps * m_Timestep;
+
+        world->setDeltaTime(m_Timestep);
+        for(unsigned int step = 0; step != steps; ++step)
+            for(const auto& system : m_Systems)
+                if(system->shouldRun())
+                    system->update();
+    }
+    else
+    {
+        // systems running every n-th frame receive the time elapsed over the
+        // last n frames
+        const std::size_t slot = m_Frame % m_TickDivisor;
+        if(m_RecentDeltas.size())
+        {
+            m_RecentDeltaSum += frameDelta - m_RecentDeltas[slot];
+            m_RecentDeltas[slot] = frameDelta;
+        }
+        else
+            m_RecentDeltaSum = frameDelta;
+
+        world->setDeltaTime(m_RecentDeltaSum);
+        for(std::size_t i = 0; i != m_Systems.size(); ++i)
+        {
+            const std::size_t phase = m_Spread ? i % m_TickDivisor : 0;
+            if(slot == phase && m_Systems[i]->shouldRun())
+                m_Systems[i]->update();
+        }
+        ++m_Frame;
+    }
+
+    world->setDeltaTime(frameDelta);
+}
+
+// ----------------------------------------------------------------------------
+void SystemGroup::setSystems(std::vector<System*> systems)
+{
+    m_Systems = std::move(systems);
+    m_Invalidated = false;
+}
+
+// ----------------------------------------------------------------------------
+const std::vector<System*>& SystemGroup::getSystems() const
+{
+    return m_Systems;
+}
+
+// ----------------------------------------------------------------------------
+void SystemGroup::invalidate()
+{
+    m_Invalidated = true;
+}
+
+// ----------------------------------------------------------------------------
+bool SystemGroup::isInvalidated() const
+{
+    return m_Invalidated;
+}
+
+} // namespace Ontology
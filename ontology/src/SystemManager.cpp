@@ -7,10 +7,17 @@
 
 #include <ontology/Config.hpp>
 #include <ontology/Exception.hpp>
+#include <ontology/SystemGroup.hpp>
 #include <ontology/SystemManager.hpp>
+#include <ontology/ThreadPool.hpp>
 #include <ontology/World.hpp>
 #include <ontology/Type.hpp>
 
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <queue>
 #include <stdexcept>
 
 #ifdef ONTOLOGY_THREAD
@@ -21,145 +28,610 @@ namespace Ontology {
 
 // ----------------------------------------------------------------------------
 SystemManager::SystemManager(World* world) :
-    m_World(world)
+    m_World(world),
+    m_DestroyedEntity(std::numeric_limits<std::size_t>::max()),
+    m_Initialised(false),
+    m_GroupsChanged(false),
+    m_ConcurrentInitialisation(false)
 {
 }
 
 // ----------------------------------------------------------------------------
 SystemManager::~SystemManager()
 {
+    // systems still initialising on the thread pool can't be destroyed yet
+    {
+        std::unique_lock<std::mutex> guard(m_InitialisedMutex);
+        m_SystemInitialised.wait(guard, [this]() {
+            return m_InitialisedSystems.size() == m_InitialisingSystems.size();
+        });
+    }
+
     for(auto it = m_SystemList.rbegin(); it != m_SystemList.rend(); ++it)
         it->second.reset(nullptr);
 }
 
+// ----------------------------------------------------------------------------
+void SystemManager::registerSystem(TypeID typeID, const std::type_info* type, System* system, std::string name)
+{
+    m_SystemList.emplace_back(type, std::unique_ptr<System>(system));
+    if(m_SystemIndex.size() <= typeID)
+        m_SystemIndex.resize(typeID + 1, nullptr);
+    m_SystemIndex[typeID] = system;
+    system->setTypeID(typeID);
+    system->setName(std::move(name));
+    this->initSystem(system);
+}
+
 // ----------------------------------------------------------------------------
 void SystemManager::initSystem(System* system)
 {
     system->setWorld(m_World);
+
+    // systems added at runtime are scheduled between two updates
+    if(m_Initialised)
+        m_PendingAdditions.push_back(system);
 }
 
 // ----------------------------------------------------------------------------
 void SystemManager::initialise()
 {
+    this->applyPendingChanges();
     this->computeExecutionOrder();
-    for(const auto& it : m_SystemList)
-        it.second->initialiseGuard(demangleTypeName(it.first->name()));
+    this->initialiseSystems();
+    m_Initialised = true;
+}
+
+// ----------------------------------------------------------------------------
+SystemManager& SystemManager::setConcurrentInitialisation(bool concurrent)
+{
+    m_ConcurrentInitialisation = concurrent;
+    return *this;
+}
+
+// ----------------------------------------------------------------------------
+void SystemManager::initialiseSystems()
+{
+    if(!m_ConcurrentInitialisation)
+    {
+        // the execution order has every system after its dependencies
+        for(const auto& system : m_ExecutionList)
+            system->initialiseGuard(system->getName());
+        return;
+    }
+
+    std::vector<std::size_t> unresolvedCount;
+    std::vector< std::vector<std::size_t> > dependants;
+    this->buildDependencyGraph(unresolvedCount, dependants);
+
+    // every system is handed to the thread pool as soon as the last system
+    // it depends on has finished initialising. Completion is tracked here
+    // rather than with ThreadPool::wait(), which would also wait for tasks
+    // unrelated to initialisation.
+    ThreadPool& pool = m_World->getThreadPool();
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::size_t remaining = m_ExecutionList.size();
+    std::exception_ptr exception;
+    std::function<void(std::size_t)> initialiseSystem = [&](std::size_t i) {
+        System* system = m_SystemList[i].second.get();
+        std::exception_ptr thrown;
+        try
+        {
+            system->initialiseGuard(system->getName());
+        }
+        catch(...)
+        {
+            thrown = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> guard(mutex);
+        if(thrown && !exception)
+            exception = thrown;
+        for(const auto& dependant : dependants[i])
+            if(--unresolvedCount[dependant] == 0)
+                pool.enqueue([&initialiseSystem, dependant]() { initialiseSystem(dependant); });
+        if(--remaining == 0)
+            finished.notify_all();
+    };
+
+    std::unique_lock<std::mutex> guard(mutex);
+    for(std::size_t i = 0; i != m_SystemList.size(); ++i)
+        if(unresolvedCount[i] == 0)
+            pool.enqueue([&initialiseSystem, i]() { initialiseSystem(i); });
+    finished.wait(guard, [&remaining]() { return remaining == 0; });
+
+    if(exception)
+        std::rethrow_exception(exception);
 }
 
 // ----------------------------------------------------------------------------
 void SystemManager::update()
 {
+    this->applyPendingChanges();
+
+    // systems joining or leaving a group can change where the group runs
+    for(const auto& group : m_Groups)
+        if(group->isInvalidated())
+        {
+            this->computeExecutionOrder();
+            break;
+        }
+    if(m_GroupsChanged)
+        this->rebuildGroups();
+
+    // grouped systems run with their group, at the position of the group's
+    // first system. orderGroups() keeps the systems of a group together.
     for(const auto& system : m_ExecutionList)
-        system->update();
+    {
+        SystemGroup* group = system->getGroup();
+        if(group == nullptr)
+        {
+            if(system->shouldRun())
+                system->update();
+        }
+        else if(group->getSystems().front() == system)
+            group->update(m_World);
+    }
 }
 
 // ----------------------------------------------------------------------------
-void SystemManager::computeExecutionOrder()
+SystemGroup& SystemManager::addGroup(const char* name)
 {
-    // no need to process if no systems are available
-    if(!m_SystemList.size())
-        return;
+    m_Groups.emplace_back(new SystemGroup(name));
+    return *m_Groups.back();
+}
+
+// ----------------------------------------------------------------------------
+void SystemManager::rebuildGroups()
+{
+    std::vector< std::vector<System*> > members(m_Groups.size());
+    for(const auto& system : m_ExecutionList)
+    {
+        if(system->getGroup() == nullptr)
+            continue;
+        for(std::size_t i = 0; i != m_Groups.size(); ++i)
+            if(m_Groups[i].get() == system->getGroup())
+                members[i].push_back(system);
+    }
+    for(std::size_t i = 0; i != m_Groups.size(); ++i)
+        m_Groups[i]->setSystems(std::move(members[i]));
+    m_GroupsChanged = false;
+}
 
-    // create temporary lists holding pointers to all systems so lookup time
-    // is faster
-    TypeMap<System*> systemLookup;
-    TypeSet unresolved;
+// ----------------------------------------------------------------------------
+void SystemManager::scheduleRemoval(System* system)
+{
     for(const auto& it : m_SystemList)
     {
-        systemLookup[it.first] = it.second.get();
-        unresolved.insert(it.first);
+        if(this->findSystem(it.second->getTypeID()) != it.second.get() || it.second.get() == system)
+            continue;
+        const std::vector<TypeID>& dependencies = it.second->getDependingSystemIDs();
+        if(std::find(dependencies.begin(), dependencies.end(), system->getTypeID()) == dependencies.end())
+            continue;
+        const std::string message = std::string("System \"") +
+            system->getName() +
+            "\" can't be removed, system \"" +
+            it.second->getName() +
+            "\" depends on it";
+        m_World->log(message);
+        ONTOLOGY_ASSERT(false, InvalidSystemException, SystemManager::removeSystem, message)
     }
 
-    // dependency resolution
-    // see http://www.electricmonk.nl/log/2008/08/07/dependency-resolving-algorithm/
-    // make sure starting point has dependencies
-    TypeSet resolving;
-    TypeSet::const_iterator systemIt = unresolved.begin();
-    while(systemIt != unresolved.end())
+    m_SystemIndex[system->getTypeID()] = nullptr;
+    m_PendingAdditions.erase(
+        std::remove(m_PendingAdditions.begin(), m_PendingAdditions.end(), system),
+        m_PendingAdditions.end()
+    );
+    m_PendingRemovals.push_back(system);
+}
+
+// ----------------------------------------------------------------------------
+void SystemManager::applyPendingChanges()
+{
+    // collect the systems that finished initialising on the thread pool
+    std::vector<System*> initialised;
+    std::exception_ptr exception;
+    {
+        std::lock_guard<std::mutex> guard(m_InitialisedMutex);
+        initialised.swap(m_InitialisedSystems);
+        exception = m_InitialiseException;
+        m_InitialiseException = nullptr;
+    }
+    for(const auto& system : initialised)
     {
-        systemIt = this->resolveDependencies(*systemIt, systemLookup, resolving, unresolved);
+        m_InitialisingSystems.erase(
+            std::remove(m_InitialisingSystems.begin(), m_InitialisingSystems.end(), system),
+            m_InitialisingSystems.end()
+        );
+        m_ReadyAdditions.push_back(system);
     }
 
-#ifdef _DEBUG
-    std::cout << "final execution order (" << m_ExecutionList.size() << " systems):" << std::endl;
-    for(auto it : m_ExecutionList)
-        for(auto m : systemLookup)
-            if(it == m.second)
+    if(m_PendingRemovals.size())
+    {
+        // systems still initialising are destroyed once they're done
+        const auto isInitialising = [this](const System* system) {
+            return std::find(m_InitialisingSystems.begin(), m_InitialisingSystems.end(), system) != m_InitialisingSystems.end();
+        };
+        const auto deferred = std::stable_partition(m_PendingRemovals.begin(), m_PendingRemovals.end(),
+            [&isInitialising](const System* system) { return !isInitialising(system); });
+        std::vector<System*> removals(m_PendingRemovals.begin(), deferred);
+        m_PendingRemovals.erase(m_PendingRemovals.begin(), deferred);
+
+        const auto isRemoval = [&removals](const System* system) {
+            return std::find(removals.begin(), removals.end(), system) != removals.end();
+        };
+        m_ExecutionList.erase(
+            std::remove_if(m_ExecutionList.begin(), m_ExecutionList.end(), isRemoval),
+            m_ExecutionList.end()
+        );
+        m_ReadyAdditions.erase(
+            std::remove_if(m_ReadyAdditions.begin(), m_ReadyAdditions.end(), isRemoval),
+            m_ReadyAdditions.end()
+        );
+        m_GroupsChanged = true;
+        m_SystemList.erase(
+            std::remove_if(m_SystemList.begin(), m_SystemList.end(),
+                [&isRemoval](const TypePair< std::unique_ptr<System> >& it) {
+                    return isRemoval(it.second.get());
+                }),
+            m_SystemList.end()
+        );
+    }
+
+    if(m_ReadyAdditions.size())
+    {
+        // insert in the order the systems were added, and only once all
+        // systems they execute after are part of the execution order
+        bool inserted = true;
+        bool recompute = false;
+        while(inserted)
+        {
+            inserted = false;
+            for(const auto& it : m_SystemList)
             {
-                std::cout << "  " << demangleTypeName(m.first->name()) << std::endl;
-                break;
+                System* system = it.second.get();
+                const auto ready = std::find(m_ReadyAdditions.begin(), m_ReadyAdditions.end(), system);
+                if(ready == m_ReadyAdditions.end())
+                    continue;
+                bool dependenciesScheduled = true;
+                for(const auto& dependency : system->getDependingSystemIDs())
+                {
+                    const System* other = this->findSystem(dependency);
+                    if(other != nullptr && this->isBeingAdded(other))
+                        dependenciesScheduled = false;
+                }
+                if(!dependenciesScheduled)
+                    continue;
+
+                m_ReadyAdditions.erase(ready);
+                system->collectEntities(m_World->getEntityManager());
+                if(!recompute)
+                    recompute = !this->insertIntoExecutionOrder(system);
+                inserted = true;
             }
-#endif
+        }
+
+        if(recompute)
+            this->computeExecutionOrder();
+    }
+
+    // systems start initialising once the systems they execute after did
+    for(auto it = m_PendingAdditions.begin(); it != m_PendingAdditions.end(); )
+    {
+        bool dependenciesInitialised = true;
+        for(const auto& dependency : (*it)->getDependingSystemIDs())
+        {
+            const System* other = this->findSystem(dependency);
+            if(other != nullptr &&
+               (std::find(m_PendingAdditions.begin(), m_PendingAdditions.end(), other) != m_PendingAdditions.end() ||
+                std::find(m_InitialisingSystems.begin(), m_InitialisingSystems.end(), other) != m_InitialisingSystems.end()))
+                dependenciesInitialised = false;
+        }
+        if(!dependenciesInitialised)
+        {
+            ++it;
+            continue;
+        }
+        this->initialiseAsync(*it);
+        it = m_PendingAdditions.erase(it);
+    }
+
+    if(exception)
+        std::rethrow_exception(exception);
 }
 
 // ----------------------------------------------------------------------------
-TypeSet::iterator SystemManager::resolveDependencies(const std::type_info* node,
-                                        const TypeMap<System*>& systemLookup,
-                                        TypeSet& resolving,
-                                        TypeSet& unresolved)
+void SystemManager::initialiseAsync(System* system)
 {
-    // lookup system referred to by node
-    System* system = systemLookup.find(node)->second;
-#ifdef _DEBUG
-    std::cout << "Processing dependencies of system " << demangleTypeName(node->name()) << std::endl;
-#endif
+    m_InitialisingSystems.push_back(system);
+    m_World->getThreadPool().enqueue([this, system]() {
+        std::exception_ptr exception;
+        try
+        {
+            system->initialiseGuard(system->getName());
+        }
+        catch(...)
+        {
+            exception = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> guard(m_InitialisedMutex);
+        if(exception && !m_InitialiseException)
+            m_InitialiseException = exception;
+        m_InitialisedSystems.push_back(system);
+        m_SystemInitialised.notify_all();
+    });
+}
+
+// ----------------------------------------------------------------------------
+bool SystemManager::isBeingAdded(const System* system) const
+{
+    return std::find(m_PendingAdditions.begin(), m_PendingAdditions.end(), system) != m_PendingAdditions.end() ||
+           std::find(m_InitialisingSystems.begin(), m_InitialisingSystems.end(), system) != m_InitialisingSystems.end() ||
+           std::find(m_ReadyAdditions.begin(), m_ReadyAdditions.end(), system) != m_ReadyAdditions.end();
+}
+
+// ----------------------------------------------------------------------------
+bool SystemManager::insertIntoExecutionOrder(System* system)
+{
+    // groups are scheduled as a whole, see orderGroups()
+    if(system->getGroup() != nullptr)
+        return false;
+
+    // find the position after the last system this one depends on
+    const std::vector<TypeID>& dependencies = system->getDependingSystemIDs();
+    std::size_t insertAt = 0;
+    std::size_t dependenciesFound = 0;
+    for(std::size_t i = 0; i != m_ExecutionList.size(); ++i)
+        if(std::find(dependencies.begin(), dependencies.end(), m_ExecutionList[i]->getTypeID()) != dependencies.end())
+        {
+            insertAt = i + 1;
+            ++dependenciesFound;
+        }
+    if(dependenciesFound != dependencies.size())
+        return false;
 
-    // node is unresolved, mark as such
-    resolving.insert(node);
+    // systems without dependencies are appended
+    if(dependencies.empty())
+        insertAt = m_ExecutionList.size();
 
-    // loop through all depending systems
-    for(const auto& edge : system->getDependingSystems())
+    // the systems of a group stay next to each other
+    while(insertAt != 0 && insertAt != m_ExecutionList.size() &&
+          m_ExecutionList[insertAt]->getGroup() != nullptr &&
+          m_ExecutionList[insertAt]->getGroup() == m_ExecutionList[insertAt - 1]->getGroup())
+        ++insertAt;
+
+    // no system before that position is allowed to depend on this one
+    for(std::size_t i = 0; i != insertAt; ++i)
     {
-        // handle depending on a non-registered system type
-        const auto& edgeSystemIt = systemLookup.find(edge);
-        ONTOLOGY_ASSERT(edgeSystemIt != systemLookup.end(), InvalidSystemException, SystemManager::resolveDependencies,
-            std::string("System \"") +
-            demangleTypeName(node->name()) +
-            "\" depends on system \"" +
-            demangleTypeName(edge->name()) +
-            "\", but it isn't registered as a system"
-        )
-        const System* edgeSystem = edgeSystemIt->second;
+        const std::vector<TypeID>& other = m_ExecutionList[i]->getDependingSystemIDs();
+        if(std::find(other.begin(), other.end(), system->getTypeID()) != other.end())
+            return false;
+    }
 
-#ifdef _DEBUG
-        std::cout << "  depends on " << edgeSystemIt->first->name() << std::endl;
-#endif
+    m_ExecutionList.insert(m_ExecutionList.begin() + insertAt, system);
+    m_GroupsChanged = true;
+    return true;
+}
 
-        // don't process edges already part of the final execution list
-        if(!this->isInExecutionList(edgeSystem))
+// ----------------------------------------------------------------------------
+void SystemManager::computeExecutionOrder()
+{
+    m_ExecutionList.clear();
+    m_GroupsChanged = true;
+
+    // topological sort using Kahn's algorithm, see
+    // https://en.wikipedia.org/wiki/Topological_sorting#Kahn's_algorithm
+    // systems are referred to by their position in m_SystemList so the
+    // systems not constrained by dependencies keep the order they were added
+    const std::size_t systemCount = m_SystemList.size();
+    std::vector<std::size_t> unresolvedCount;
+    std::vector< std::vector<std::size_t> > dependants;
+    this->checkDependencies();
+    this->buildDependencyGraph(unresolvedCount, dependants);
+
+    // repeatedly schedule systems with no unresolved dependencies left
+    // systems still being added at runtime join once they're initialised
+    std::vector<std::size_t> ready;
+    for(std::size_t i = 0; i != systemCount; ++i)
+        if(unresolvedCount[i] == 0)
+            ready.push_back(i);
+    for(std::size_t next = 0; next != ready.size(); ++next)
+    {
+        System* system = m_SystemList[ready[next]].second.get();
+        if(!this->isBeingAdded(system))
+            m_ExecutionList.push_back(system);
+        for(const auto& dependant : dependants[ready[next]])
+            if(--unresolvedCount[dependant] == 0)
+                ready.push_back(dependant);
+    }
+
+    // any system left over is part of or waiting on a cycle. Without
+    // assertions these systems never run, so name one of the dependencies
+    // involved rather than dropping them silently
+    if(ready.size() != systemCount)
+    {
+        std::string message;
+        for(std::size_t i = 0; i != systemCount && message.empty(); ++i)
         {
-            // handle circular dependencies
-            ONTOLOGY_ASSERT(resolving.find(edge) == resolving.end(), CircularDependencyException, SystemManager::resolveDependencies,
-                std::string("circular dependency detected with systems \"") +
-                demangleTypeName(node->name()) +
-                "\" and \"" +
-                demangleTypeName(edge->name()) + "\""
-            )
-            this->resolveDependencies(edge, systemLookup, resolving, unresolved);
+            if(unresolvedCount[i] == 0)
+                continue;
+            for(const auto& dependant : dependants[i])
+                if(unresolvedCount[dependant] != 0)
+                {
+                    message = std::string("circular dependency detected with systems \"") +
+                        m_SystemList[i].second->getName() +
+                        "\" and \"" +
+                        m_SystemList[dependant].second->getName() + "\"";
+                    break;
+                }
         }
+        m_World->log(message);
+        ONTOLOGY_ASSERT(false, CircularDependencyException, SystemManager::computeExecutionOrder, message)
+    }
+
+    this->orderGroups();
+
 #ifdef _DEBUG
-        else
-            std::cout << "   --> already in execution list" << std::endl;
+    m_World->log("final execution order (" + std::to_string(m_ExecutionList.size()) + " systems):");
+    for(const auto& system : m_ExecutionList)
+        m_World->log("  " + system->getName());
 #endif
+}
+
+// ----------------------------------------------------------------------------
+void SystemManager::orderGroups()
+{
+    // a group runs all of its systems at once, so it is scheduled as a single
+    // node. Nodes are numbered in the order they first appear in the
+    // execution order, which is kept where dependencies allow.
+    const std::size_t systemCount = m_ExecutionList.size();
+    const std::size_t none = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> node(systemCount);
+    std::vector<std::size_t> position(m_SystemIndex.size(), none);
+    std::vector<const SystemGroup*> nodeGroups;
+    std::vector< std::vector<System*> > nodeSystems;
+    for(std::size_t i = 0; i != systemCount; ++i)
+    {
+        System* system = m_ExecutionList[i];
+        const SystemGroup* group = system->getGroup();
+        auto it = std::find(nodeGroups.begin(), nodeGroups.end(), group);
+        if(group == nullptr || it == nodeGroups.end())
+        {
+            nodeGroups.push_back(group);
+            nodeSystems.push_back(std::vector<System*>());
+            it = nodeGroups.end() - 1;
+        }
+        node[i] = static_cast<std::size_t>(it - nodeGroups.begin());
+        nodeSystems[node[i]].push_back(system);
+        position[system->getTypeID()] = i;
+    }
+    if(nodeGroups.size() == systemCount)
+        return;
+
+    const std::size_t nodeCount = nodeGroups.size();
+    std::vector<std::size_t> unresolvedCount(nodeCount, 0);
+    std::vector< std::vector<std::size_t> > dependants(nodeCount);
+    for(std::size_t i = 0; i != systemCount; ++i)
+        for(const auto& edge : m_ExecutionList[i]->getDependingSystemIDs())
+        {
+            if(edge >= position.size() || position[edge] == none || node[position[edge]] == node[i])
+                continue;
+            ++unresolvedCount[node[i]];
+            dependants[node[position[edge]]].push_back(node[i]);
+        }
+
+    // Kahn's algorithm again, always scheduling the earliest ready node
+    std::priority_queue<std::size_t, std::vector<std::size_t>, std::greater<std::size_t> > ready;
+    for(std::size_t i = 0; i != nodeCount; ++i)
+        if(unresolvedCount[i] == 0)
+            ready.push(i);
+    std::size_t scheduled = 0;
+    m_ExecutionList.clear();
+    while(!ready.empty())
+    {
+        const std::size_t next = ready.top();
+        ready.pop();
+        ++scheduled;
+        m_ExecutionList.insert(m_ExecutionList.end(), nodeSystems[next].begin(), nodeSystems[next].end());
+        for(const auto& dependant : dependants[next])
+            if(--unresolvedCount[dependant] == 0)
+                ready.push(dependant);
     }
-    resolving.erase(resolving.find(node));
 
-    m_ExecutionList.push_back(system);
-    return unresolved.erase(unresolved.find(node));
+    if(scheduled != nodeCount)
+    {
+        const auto nameOf = [&](std::size_t i) {
+            return nodeGroups[i] ?
+                std::string("group \"") + nodeGroups[i]->getName() + "\"" :
+                std::string("system \"") + nodeSystems[i].front()->getName() + "\"";
+        };
+        std::string message;
+        for(std::size_t i = 0; i != nodeCount && message.empty(); ++i)
+        {
+            if(unresolvedCount[i] == 0)
+                continue;
+            for(const auto& dependant : dependants[i])
+                if(unresolvedCount[dependant] != 0)
+                {
+                    message = "circular dependency detected with " + nameOf(i) + " and " + nameOf(dependant);
+                    break;
+                }
+        }
+        m_World->log(message);
+        ONTOLOGY_ASSERT(false, CircularDependencyException, SystemManager::computeExecutionOrder, message)
+    }
 }
 
 // ----------------------------------------------------------------------------
-bool SystemManager::isInExecutionList(const System* const system) const
+void SystemManager::checkDependencies() const
 {
-    for(const auto& it : m_ExecutionList)
-        if(it == system)
-            return true;
-    return false;
+    for(const auto& it : m_SystemList)
+    {
+        bool registered = true;
+        for(const auto& dependency : it.second->getDependingSystemIDs())
+            registered = registered && this->findSystem(dependency) != nullptr;
+        if(registered)
+            continue;
+
+        // only look up the types to name the missing systems
+        for(const auto& edgeType : it.second->getDependingSystems())
+        {
+            if(m_SystemList.find(edgeType) != m_SystemList.end())
+                continue;
+            const std::string message = std::string("System \"") +
+                it.second->getName() +
+                "\" depends on system \"" +
+                demangleTypeName(edgeType->name()) +
+                "\", but it isn't registered as a system";
+            m_World->log(message);
+            ONTOLOGY_ASSERT(false, InvalidSystemException, SystemManager::computeExecutionOrder, message)
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+void SystemManager::buildDependencyGraph(std::vector<std::size_t>& unresolvedCount,
+                                         std::vector< std::vector<std::size_t> >& dependants) const
+{
+    const std::size_t systemCount = m_SystemList.size();
+    std::vector<std::size_t> position(m_SystemIndex.size());
+    for(std::size_t i = 0; i != systemCount; ++i)
+        position[m_SystemList[i].second->getTypeID()] = i;
+
+    // count the unresolved dependencies of every system and collect which
+    // systems are waiting on it
+    unresolvedCount.assign(systemCount, 0);
+    dependants.assign(systemCount, std::vector<std::size_t>());
+    for(std::size_t i = 0; i != systemCount; ++i)
+    {
+        const System* system = m_SystemList[i].second.get();
+        for(const auto& edge : system->getDependingSystemIDs())
+        {
+            // dependencies on systems that aren't registered are reported by
+            // checkDependencies()
+            if(this->findSystem(edge) == nullptr)
+                continue;
+
+            ++unresolvedCount[i];
+            dependants[position[edge]].push_back(i);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+System* SystemManager::findSystem(TypeID typeID) const
+{
+    if(typeID >= m_SystemIndex.size())
+        return nullptr;
+    return m_SystemIndex[typeID];
 }
 
 // ----------------------------------------------------------------------------
 void SystemManager::onAddComponent(Entity& entity, const Component* component)
 {
+    m_World->markChanged(&typeid(*component));
     for(const auto& it : m_SystemList)
         it.second->informEntityUpdate(entity);
 }
@@ -167,6 +639,11 @@ void SystemManager::onAddComponent(Entity& entity, const Component* component)
 // ----------------------------------------------------------------------------
 void SystemManager::onRemoveComponent(Entity& entity, const Component* component)
 {
+    m_World->markChanged(&typeid(*component));
+
+    // a destroyed entity releases its components after systems forgot it
+    if(entity.getID() == m_DestroyedEntity)
+        return;
     for(const auto& it : m_SystemList)
         it.second->informEntityUpdate(entity);
 }
@@ -174,6 +651,7 @@ void SystemManager::onRemoveComponent(Entity& entity, const Component* component
 // ----------------------------------------------------------------------------
 void SystemManager::onDestroyEntity(Entity& entity)
 {
+    m_DestroyedEntity = entity.getID();
     for(const auto& it : m_SystemList)
         it.second->informDestroyedEntity(entity);
 }
@@ -185,4 +663,11 @@ void SystemManager::onEntitiesReallocated(std::vector<Entity>& entityList)
         it.second->informEntitiesReallocated(entityList);
 }
 
+// ----------------------------------------------------------------------------
+void SystemManager::onEntitiesMoved(std::vector<Entity>& entityList, std::size_t first, const std::vector<std::size_t>& destinations)
+{
+    for(const auto& it : m_SystemList)
+        it.second->informEntitiesMoved(entityList, first, destinations);
+}
+
 } // namespace Ontology
@@ -0,0 +1,208 @@
+// ----------------------------------------------------------------------------
+// ThreadPool.cpp
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <ontology/ThreadPool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace Ontology {
+
+// ----------------------------------------------------------------------------
+static std::size_t resolveThreadCount(std::size_t threadCount)
+{
+    if(threadCount)
+        return threadCount;
+    const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads ? hardwareThreads : 1;
+}
+
+// ----------------------------------------------------------------------------
+// Shared between the caller of parallelFor() and the workers helping it.
+// Workers may only pick up their task after the caller returned, so it is
+// kept alive by the tasks.
+struct ParallelForState
+{
+    std::atomic<std::size_t>        nextChunk;
+    std::atomic<std::size_t>        finishedChunks;
+    std::size_t                     chunkCount;
+    std::size_t                     count;
+    std::size_t                     grainSize;
+    const ThreadPool::RangeTask*    task;
+    std::mutex                      mutex;
+    std::condition_variable         finished;
+    std::exception_ptr              exception;
+};
+
+// ----------------------------------------------------------------------------
+static void processChunks(ParallelForState& state)
+{
+    while(true)
+    {
+        const std::size_t chunk = state.nextChunk++;
+        if(chunk >= state.chunkCount)
+            return;
+
+        const std::size_t first = chunk * state.grainSize;
+        const std::size_t last = std::min(first + state.grainSize, state.count);
+        try
+        {
+            (*state.task)(first, last);
+        }
+        catch(...)
+        {
+            std::lock_guard<std::mutex> guard(state.mutex);
+            if(!state.exception)
+                state.exception = std::current_exception();
+        }
+
+        if(++state.finishedChunks == state.chunkCount)
+        {
+            std::lock_guard<std::mutex> guard(state.mutex);
+            state.finished.notify_all();
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+ThreadPool::ThreadPool(std::size_t threadCount) :
+    m_ThreadCount(resolveThreadCount(threadCount)),
+    m_UnfinishedTasks(0),
+    m_Stopping(false)
+{
+}
+
+// ----------------------------------------------------------------------------
+ThreadPool::~ThreadPool()
+{
+    this->stop();
+}
+
+// ----------------------------------------------------------------------------
+void ThreadPool::setThreadCount(std::size_t threadCount)
+{
+    this->stop();
+    m_ThreadCount = resolveThreadCount(threadCount);
+}
+
+// ----------------------------------------------------------------------------
+std::size_t ThreadPool::getThreadCount() const
+{
+    return m_ThreadCount;
+}
+
+// ----------------------------------------------------------------------------
+void ThreadPool::enqueue(Task task)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_Mutex);
+        if(m_Threads.empty())
+            this->start();
+        m_Tasks.push_back(std::move(task));
+        ++m_UnfinishedTasks;
+    }
+    m_TaskQueued.notify_one();
+}
+
+// ----------------------------------------------------------------------------
+void ThreadPool::parallelFor(std::size_t count, std::size_t grainSize, const RangeTask& task)
+{
+    if(count == 0)
+        return;
+    grainSize = std::max<std::size_t>(grainSize, 1);
+
+    const std::shared_ptr<ParallelForState> state(new ParallelForState);
+    state->nextChunk = 0;
+    state->finishedChunks = 0;
+    state->chunkCount = (count + grainSize - 1) / grainSize;
+    state->count = count;
+    state->grainSize = grainSize;
+    state->task = &task;
+
+    // the calling thread processes chunks too, so one helper fewer is needed
+    const std::size_t helpers = std::min(m_ThreadCount, state->chunkCount - 1);
+    for(std::size_t i = 0; i != helpers; ++i)
+        this->enqueue([state]() { processChunks(*state); });
+    processChunks(*state);
+
+    std::unique_lock<std::mutex> guard(state->mutex);
+    state->finished.wait(guard, [&state]() { return state->finishedChunks == state->chunkCount; });
+    if(state->exception)
+        std::rethrow_exception(state->exception);
+}
+
+// ----------------------------------------------------------------------------
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> guard(m_Mutex);
+    m_TasksFinished.wait(guard, [this]() { return m_UnfinishedTasks == 0; });
+
+    if(m_Exception)
+    {
+        std::exception_ptr exception = m_Exception;
+        m_Exception = nullptr;
+        std::rethrow_exception(exception);
+    }
+}
+
+// ----------------------------------------------------------------------------
+void ThreadPool::start()
+{
+    // called with m_Mutex held
+    m_Stopping = false;
+    for(std::size_t i = 0; i != m_ThreadCount; ++i)
+        m_Threads.emplace_back(&ThreadPool::run, this);
+}
+
+// ----------------------------------------------------------------------------
+void ThreadPool::stop()
+{
+    {
+        std::unique_lock<std::mutex> guard(m_Mutex);
+        m_TasksFinished.wait(guard, [this]() { return m_UnfinishedTasks == 0; });
+        m_Stopping = true;
+    }
+    m_TaskQueued.notify_all();
+    for(auto& thread : m_Threads)
+        thread.join();
+    m_Threads.clear();
+}
+
+// ----------------------------------------------------------------------------
+void ThreadPool::run()
+{
+    std::unique_lock<std::mutex> guard(m_Mutex);
+    while(true)
+    {
+        m_TaskQueued.wait(guard, [this]() { return m_Stopping || !m_Tasks.empty(); });
+        if(m_Tasks.empty())
+            return;
+
+        Task task = std::move(m_Tasks.front());
+        m_Tasks.pop_front();
+        guard.unlock();
+
+        std::exception_ptr exception;
+        try
+        {
+            task();
+        }
+        catch(...)
+        {
+            exception = std::current_exception();
+        }
+
+        guard.lock();
+        if(exception && !m_Exception)
+            m_Exception = exception;
+        if(--m_UnfinishedTasks == 0)
+            m_TasksFinished.notify_all();
+    }
+}
+
+} // namespace Ontology
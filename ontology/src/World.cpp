@@ -9,23 +9,141 @@
 #include <ontology/EntityManager.hpp>
 #include <ontology/SystemManager.hpp>
 #include <ontology/Entity.hpp>
+#include <ontology/EventChannel.hpp>
+#include <ontology/FrameAllocator.hpp>
+#include <ontology/Hierarchy.hpp>
+#include <ontology/SpatialIndex.hpp>
+#include <ontology/ThreadPool.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
 
 namespace Ontology {
 
+// ----------------------------------------------------------------------------
+// Types are mapped to dense change IDs through an open addressing table keyed
+// by the address of their type_info. Entries are never removed, so lookups
+// don't need a lock, only registering a new type does.
+static const std::size_t ChangeTypeTableSize = 4096;
+static std::atomic<const std::type_info*> changeTypes[ChangeTypeTableSize];
+static TypeID changeTypeIDs[ChangeTypeTableSize];
+
+// Once the table is full, further types share this ID. Changing any of them
+// flags all of them as changed.
+static const TypeID OverflowChangeID = ChangeTypeTableSize - 1;
+
+struct ChangeFamily;
+typedef TypeIDGenerator<ChangeFamily> ChangeID;
+
+// ----------------------------------------------------------------------------
+static std::mutex& getChangeTypeMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+// ----------------------------------------------------------------------------
+// Looks up the slot of a type, or the empty slot it would be inserted at.
+// Returns ChangeTypeTableSize if the table is full.
+static std::size_t findChangeTypeSlot(const std::type_info* type)
+{
+    const std::size_t hash = static_cast<std::size_t>(
+        (reinterpret_cast<std::uintptr_t>(type) >> 3) * 0x9E3779B97F4A7C15ull);
+    for(std::size_t probe = 0; probe != ChangeTypeTableSize; ++probe)
+    {
+        const std::size_t slot = (hash + probe) & (ChangeTypeTableSize - 1);
+        const std::type_info* entry = changeTypes[slot].load(std::memory_order_acquire);
+        if(entry == type || entry == nullptr)
+            return slot;
+    }
+    return ChangeTypeTableSize;
+}
+
+// ----------------------------------------------------------------------------
+// Change ticks and event channels are stored in blocks of doubling size,
+// allocated on first use.
+static const std::size_t FirstBlockSize = 64;
+
+static std::size_t getBlock(TypeID id, TypeID& blockBegin)
+{
+    std::size_t block = 0;
+    blockBegin = 0;
+    while(id >= blockBegin + (FirstBlockSize << block))
+        blockBegin += FirstBlockSize << block++;
+    return block;
+}
+
+// ----------------------------------------------------------------------------
+TypeID World::getChangeID(const std::type_info* type)
+{
+    std::size_t slot = findChangeTypeSlot(type);
+    if(slot != ChangeTypeTableSize && changeTypes[slot].load(std::memory_order_acquire) == type)
+        return changeTypeIDs[slot];
+
+    std::lock_guard<std::mutex> guard(getChangeTypeMutex());
+    slot = findChangeTypeSlot(type);
+    if(slot == ChangeTypeTableSize || ChangeID::count() == OverflowChangeID)
+        return OverflowChangeID;
+    if(changeTypes[slot].load(std::memory_order_relaxed) == type)
+        return changeTypeIDs[slot];
+
+    // the same type may be described by several type_info objects when
+    // shared libraries are involved
+    TypeID changeID = ChangeTypeTableSize;
+    for(std::size_t i = 0; i != ChangeTypeTableSize; ++i)
+    {
+        const std::type_info* entry = changeTypes[i].load(std::memory_order_relaxed);
+        if(entry != nullptr && *entry == *type)
+            changeID = changeTypeIDs[i];
+    }
+    if(changeID == ChangeTypeTableSize)
+        changeID = ChangeID::next();
+
+    changeTypeIDs[slot] = changeID;
+    changeTypes[slot].store(type, std::memory_order_release);
+    return changeID;
+}
+
 // ----------------------------------------------------------------------------
 
 World::World() :
+    m_ThreadPool(new ThreadPool),
+    m_FrameAllocator(new FrameAllocator),
     m_EntityManager(new EntityManager(this)),
     m_SystemManager(new SystemManager(this)),
-    m_DeltaTime(0.0)
+    m_Hierarchy(new Hierarchy(this)),
+    m_ChangeTick(0),
+    m_Logger([](const std::string& message) { std::cout << message << std::endl; }),
+    m_DeltaTime(0.0),
+    m_Deterministic(false)
 {
+    static_assert(FirstBlockSize * ((1u << ChangeTickBlockCount) - 1) >= ChangeTypeTableSize,
+        "change tick blocks must cover every change ID");
+    for(auto& block : m_ChangeTickBlocks)
+        block.store(nullptr);
+    for(auto& block : m_EventChannelBlocks)
+        block.store(nullptr);
     m_EntityManager->event.addListener(m_SystemManager.get(), "SystemManager");
+    m_EntityManager->event.addListener(m_Hierarchy.get(), "Hierarchy");
 }
 
 // ----------------------------------------------------------------------------
 World::~World()
 {
     m_EntityManager->event.removeListener("SystemManager");
+    m_EntityManager->event.removeListener("Hierarchy");
+    for(auto& block : m_ChangeTickBlocks)
+        delete[] block.load();
+    for(std::size_t block = 0; block != EventChannelBlockCount; ++block)
+    {
+        std::atomic<EventChannelBase*>* channels = m_EventChannelBlocks[block].load();
+        if(channels == nullptr)
+            continue;
+        for(std::size_t i = 0; i != FirstBlockSize << block; ++i)
+            delete channels[i].load();
+        delete[] channels;
+    }
 }
 
 // ----------------------------------------------------------------------------
@@ -40,6 +158,122 @@ SystemManager& World::getSystemManager() const
     return *m_SystemManager.get();
 }
 
+// ----------------------------------------------------------------------------
+ThreadPool& World::getThreadPool() const
+{
+    return *m_ThreadPool.get();
+}
+
+// ----------------------------------------------------------------------------
+FrameAllocator& World::getFrameAllocator() const
+{
+    return *m_FrameAllocator.get();
+}
+
+// ----------------------------------------------------------------------------
+Hierarchy& World::getHierarchy() const
+{
+    return *m_Hierarchy.get();
+}
+
+// ----------------------------------------------------------------------------
+std::vector<Entity::ID> World::queryRadius(SpatialPoint center, float radius) const
+{
+    ONTOLOGY_ASSERT(m_SpatialIndex, InvalidSpatialIndexException, World::queryRadius,
+        "No spatial index was added to this world"
+    )
+    return m_SpatialIndex->queryRadius(*this, center, radius);
+}
+
+// ----------------------------------------------------------------------------
+std::vector<Entity::ID> World::queryAABB(SpatialPoint min, SpatialPoint max) const
+{
+    ONTOLOGY_ASSERT(m_SpatialIndex, InvalidSpatialIndexException, World::queryAABB,
+        "No spatial index was added to this world"
+    )
+    return m_SpatialIndex->queryAABB(*this, min, max);
+}
+
+// ----------------------------------------------------------------------------
+void World::setLogger(Logger logger)
+{
+    std::lock_guard<std::mutex> guard(m_LoggerMutex);
+    m_Logger = std::move(logger);
+}
+
+// ----------------------------------------------------------------------------
+void World::log(const std::string& message) const
+{
+    std::lock_guard<std::mutex> guard(m_LoggerMutex);
+    if(m_Logger)
+        m_Logger(message);
+}
+
+// ----------------------------------------------------------------------------
+void World::markChanged(const std::type_info* type)
+{
+    this->markChanged(World::getChangeID(type));
+}
+
+// ----------------------------------------------------------------------------
+void World::markChanged(TypeID changeID)
+{
+    TypeID blockBegin;
+    const std::size_t block = getBlock(changeID, blockBegin);
+    std::atomic<std::uint64_t>* ticks = m_ChangeTickBlocks[block].load(std::memory_order_acquire);
+    if(ticks == nullptr)
+    {
+        // several threads may allocate the block at once, only one wins
+        std::atomic<std::uint64_t>* allocated = new std::atomic<std::uint64_t>[FirstBlockSize << block]();
+        if(m_ChangeTickBlocks[block].compare_exchange_strong(ticks, allocated, std::memory_order_acq_rel))
+            ticks = allocated;
+        else
+            delete[] allocated;
+    }
+
+    // ticks only ever increase, even if a later change is stored first
+    const std::uint64_t tick = ++m_ChangeTick;
+    std::atomic<std::uint64_t>& slot = ticks[changeID - blockBegin];
+    std::uint64_t previous = slot.load(std::memory_order_relaxed);
+    while(previous < tick && !slot.compare_exchange_weak(previous, tick, std::memory_order_relaxed))
+        ;
+}
+
+// ----------------------------------------------------------------------------
+std::uint64_t World::getChangeTick(const std::type_info* type) const
+{
+    return this->getChangeTick(World::getChangeID(type));
+}
+
+// ----------------------------------------------------------------------------
+std::uint64_t World::getChangeTick(TypeID changeID) const
+{
+    TypeID blockBegin;
+    const std::size_t block = getBlock(changeID, blockBegin);
+    const std::atomic<std::uint64_t>* ticks = m_ChangeTickBlocks[block].load(std::memory_order_acquire);
+    if(ticks == nullptr)
+        return 0;
+    return ticks[changeID - blockBegin].load(std::memory_order_relaxed);
+}
+
+// ----------------------------------------------------------------------------
+std::uint64_t World::getChangeTick() const
+{
+    return m_ChangeTick.load();
+}
+
+// ----------------------------------------------------------------------------
+void World::setDeterministic(bool deterministic)
+{
+    m_Deterministic = deterministic;
+}
+
+// ----------------------------------------------------------------------------
+bool World::isDeterministic() const
+{
+    return m_Deterministic;
+}
+
 // ----------------------------------------------------------------------------
 void World::setDeltaTime(float deltaTime)
 {
@@ -52,10 +286,65 @@ float World::getDeltaTime() const
     return m_DeltaTime;
 }
 
+// ----------------------------------------------------------------------------
+EventChannelBase* World::getEventChannel(TypeID eventID) const
+{
+    TypeID blockBegin;
+    const std::size_t block = getBlock(eventID, blockBegin);
+    const std::atomic<EventChannelBase*>* channels = m_EventChannelBlocks[block].load(std::memory_order_acquire);
+    if(channels == nullptr)
+        return nullptr;
+    return channels[eventID - blockBegin].load(std::memory_order_acquire);
+}
+
+// ----------------------------------------------------------------------------
+EventChannelBase* World::addEventChannel(TypeID eventID, EventChannelBase* channel)
+{
+    TypeID blockBegin;
+    const std::size_t block = getBlock(eventID, blockBegin);
+    std::atomic<EventChannelBase*>* channels = m_EventChannelBlocks[block].load(std::memory_order_acquire);
+    if(channels == nullptr)
+    {
+        // several threads may allocate the block at once, only one wins
+        std::atomic<EventChannelBase*>* allocated = new std::atomic<EventChannelBase*>[FirstBlockSize << block]();
+        if(m_EventChannelBlocks[block].compare_exchange_strong(channels, allocated, std::memory_order_acq_rel))
+            channels = allocated;
+        else
+            delete[] allocated;
+    }
+
+    EventChannelBase* stored = nullptr;
+    if(channels[eventID - blockBegin].compare_exchange_strong(stored, channel, std::memory_order_acq_rel))
+        return channel;
+    delete channel;
+    return stored;
+}
+
+// ----------------------------------------------------------------------------
+void World::flushEvents()
+{
+    const TypeID eventCount = EventID::count();
+    for(TypeID eventID = 0; eventID != eventCount; ++eventID)
+        if(EventChannelBase* channel = this->getEventChannel(eventID))
+            channel->flush();
+}
+
 // ----------------------------------------------------------------------------
 void World::update()
 {
+    // pick up events posted by other threads and changes made to entities
+    // since the last frame
+    this->flushEvents();
+    m_EntityManager->dispatchEntityEvents();
     m_SystemManager->update();
+    if(m_SpatialIndex)
+        m_SpatialIndex->reorderEntities(*m_EntityManager);
+
+    const TypeID eventCount = EventID::count();
+    for(TypeID eventID = 0; eventID != eventCount; ++eventID)
+        if(EventChannelBase* channel = this->getEventChannel(eventID))
+            channel->swapBuffers();
+    m_FrameAllocator->reset();
 }
 
 } // namespace Ontology
@@ -23,6 +23,10 @@ struct NonExistingComponent : public Component
 {
 };
 
+struct TestTag : public Component
+{
+};
+
 // insert ourselves between System events so the components can be upcast
 // to TestComponent. This is so they can be tested.
 class MockEntityManagerHelper : public EntityManagerInterface
@@ -37,9 +41,11 @@ class MockEntityManagerHelper : public EntityManagerInterface
     // to. This is only here to make the compiler happy.
     Entity& createEntity(const char* name) override { return e; }
     Entity& getEntity(Entity::ID) override { return e; }
+    SharedComponentPool& getSharedComponentPool() const override { return pool; }
     
     Entity e; // dummy entity
     World w; // dummy world
+    mutable SharedComponentPool pool;
 
 public:
     MockEntityManagerHelper() : EntityManagerInterface(&w), e("dont_call_this", this) {}
@@ -56,6 +62,8 @@ struct MockEntityManager : public MockEntityManagerHelper
     MOCK_METHOD0(destroyAllEntities, void());
     MOCK_CONST_METHOD2(informAddComponentHelper, void(Entity&, const TestComponent*));
     MOCK_CONST_METHOD2(informRemoveComponentHelper, void(Entity&, const TestComponent*));
+    MOCK_CONST_METHOD2(addEntityListener, void(Entity::ID, EntityListener*));
+    MOCK_CONST_METHOD2(removeEntityListener, void(Entity::ID, EntityListener*));
 };
 
 struct TestSystem : public System
@@ -64,3 +72,15 @@ struct TestSystem : public System
     void processEntity(Entity&) override {}
     MOCK_METHOD2(configureEntity, void(Entity&, std::string));
 };
+
+struct ConfigurableSystem : public System
+{
+    struct Config
+    {
+        float speed;
+        bool canJump;
+    };
+    void initialise() override {}
+    void processEntity(Entity&) override {}
+    void configureEntity(Entity&, std::string) override {}
+};
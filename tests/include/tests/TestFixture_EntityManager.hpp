@@ -19,6 +19,30 @@ struct TestComponent : public Component
     }
 };
 
+struct SharedComponent : public Component
+{
+    SharedComponent(int value) : value(value) {}
+    int value;
+    bool operator==(const SharedComponent& other) const
+    {
+        return value == other.value;
+    }
+};
+
+struct HashableSharedComponent : public SharedComponent
+{
+    HashableSharedComponent(int value) : SharedComponent(value) {}
+};
+
+namespace std {
+    template <>
+    struct hash<HashableSharedComponent>
+    {
+        std::size_t operator()(const HashableSharedComponent& component) const
+        { return std::hash<int>()(component.value); }
+    };
+}
+
 // insert ourselves between listener calls and upcast returned components
 // so they can be tested.
 class ListenerHelper : public EntityManagerListener
@@ -48,4 +72,28 @@ struct MockEntityManagerListener : public ListenerHelper
     MOCK_METHOD2(onAddComponentHelper, void(Entity&, const TestComponent*));
     MOCK_METHOD2(onRemoveComponentHelper, void(Entity&, const TestComponent*));
     MOCK_METHOD1(onEntitiesReallocatedHelper, void(std::vector<Entity>&));
-};
\ No newline at end of file
+};
+
+// records the events it receives, in order
+struct RecordingEntityListener : public EntityListener
+{
+    void onAddComponent(Entity::ID entity, const Component* component) override
+    { events.push_back("add " + std::to_string(static_cast<const TestComponent*>(component)->x)); }
+    void onRemoveComponent(Entity::ID entity, const Component* component) override
+    { events.push_back("remove " + std::to_string(static_cast<const TestComponent*>(component)->x)); }
+    void onDestroyEntity(Entity::ID entity) override
+    { events.push_back("destroy"); }
+
+    std::vector<std::string> events;
+};
+
+// collects the x coordinate of every entity it processes
+struct CollectingSystem : public System
+{
+    void initialise() override {}
+    void processEntity(Entity& e) override
+    { values.push_back(e.getComponent<TestComponent>().x); }
+    void configureEntity(Entity&, std::string) override {}
+
+    std::vector<int> values;
+};
@@ -0,0 +1,183 @@
+#include <tests/Config.hpp>
+#include <gmock/gmock.h>
+#include <ontology/Ontology.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#define NAME SystemManager
+
+using namespace Ontology;
+
+// ----------------------------------------------------------------------------
+// test fixture
+// ----------------------------------------------------------------------------
+
+struct Position : public Component
+{
+    Position(int x, int y) : x(x), y(y) {}
+    int x, y;
+};
+
+struct Velocity : public Component
+{
+    Velocity(int x, int y) : x(x), y(y) {}
+    int x, y;
+};
+
+struct Marked : public Component
+{
+};
+
+struct Friction : public Component
+{
+    Friction(int value) : value(value) {}
+    int value;
+    bool operator==(const Friction& other) const { return value == other.value; }
+};
+
+template <int N>
+struct OrderedSystem : public System
+{
+    void initialise() override {}
+    void processEntity(Entity&) override {}
+    void configureEntity(Entity&, std::string) override {}
+};
+typedef OrderedSystem<0> SystemA;
+typedef OrderedSystem<1> SystemB;
+typedef OrderedSystem<2> SystemC;
+typedef OrderedSystem<3> SystemD;
+
+// records the order in which systems finish initialising, and on which thread
+struct InitialisationLog
+{
+    void add(int system)
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        order.push_back(system);
+        threads.push_back(std::this_thread::get_id());
+    }
+    std::mutex mutex;
+    std::vector<int> order;
+    std::vector<std::thread::id> threads;
+};
+
+template <int N>
+struct LoggingSystem : public System
+{
+    LoggingSystem(InitialisationLog& log) : log(log) {}
+    void initialise() override { log.add(N); }
+    void processEntity(Entity&) override {}
+    void configureEntity(Entity&, std::string) override {}
+    InitialisationLog& log;
+};
+
+// keeps initialising until released
+struct BlockingSystem : public System
+{
+    BlockingSystem() : release(false) {}
+    void initialise() override
+    {
+        while(!release)
+            std::this_thread::yield();
+    }
+    void processEntity(Entity&) override {}
+    void configureEntity(Entity&, std::string) override {}
+    std::atomic<bool> release;
+};
+
+// counts updates and remembers the delta time of the last one
+template <int N>
+struct CountingSystem : public System
+{
+    CountingSystem() : updates(0), deltaTime(0.0f) {}
+    void initialise() override {}
+    void processEntity(Entity&) override {}
+    void configureEntity(Entity&, std::string) override {}
+    void processEntities(EntityList::iterator, EntityList::iterator) override
+    {
+        ++updates;
+        deltaTime = world->getDeltaTime();
+    }
+    int updates;
+    float deltaTime;
+};
+
+// records the IDs of its entities through the command buffers
+struct RecordingSystem : public System
+{
+    void initialise() override {}
+    void processEntity(Entity& entity) override
+    {
+        const Entity::ID id = entity.getID();
+        std::vector<Entity::ID>* recorded = &this->recorded;
+        this->getCommandBuffer().push([recorded, id](World&) {
+            recorded->push_back(id);
+        });
+    }
+    void configureEntity(Entity&, std::string) override {}
+    std::vector<Entity::ID> recorded;
+};
+
+// destroys every entity it processes
+struct DestroyingSystem : public System
+{
+    void initialise() override {}
+    void processEntity(Entity& entity) override
+    {
+        this->getCommandBuffer().destroyEntity(entity.getID());
+    }
+    void configureEntity(Entity&, std::string) override {}
+};
+
+// tags every entity it processes
+struct MarkingSystem : public System
+{
+    void initialise() override {}
+    void processEntity(Entity& entity) override
+    {
+        this->getCommandBuffer().addComponent<Marked>(entity.getID());
+    }
+    void configureEntity(Entity&, std::string) override {}
+};
+
+// aggregates positions through reductions, which must be merged after the update
+struct ReducingSystem : public System
+{
+    void initialise() override {}
+    void processEntity(Entity& entity) override
+    {
+        Position& position = entity.getComponent<Position>();
+        count.local() += 1;
+        maxX.local() = std::max(maxX.local(), position.x);
+    }
+    void configureEntity(Entity&, std::string) override {}
+
+    Reduction<int> count{*this};
+    Reduction<int> maxX{*this, -1, [](const int& a, const int& b) { return std::max(a, b); }};
+};
+
+// records the order in which it processes entities
+struct OrderRecordingSystem : public System
+{
+    void initialise() override {}
+    void processEntity(Entity& entity) override
+    {
+        order.push_back(entity.getComponent<Position>().x);
+    }
+    void configureEntity(Entity&, std::string) override {}
+
+    std::vector<int> order;
+};
+
+// counts how often its entity list was reported as changed
+struct ListChangeCountingSystem : public System
+{
+    ListChangeCountingSystem() : changes(0) {}
+    void initialise() override {}
+    void processEntity(Entity&) override {}
+    void configureEntity(Entity&, std::string) override {}
+    void onEntityListChanged(EntityList&) override { ++changes; }
+    int changes;
+};
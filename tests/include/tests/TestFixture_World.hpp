@@ -0,0 +1,22 @@
+#include <tests/Config.hpp>
+#include <gmock/gmock.h>
+#include <ontology/Ontology.hpp>
+#define NAME World
+
+using namespace Ontology;
+
+// ----------------------------------------------------------------------------
+// test fixture
+// ----------------------------------------------------------------------------
+
+struct Camera
+{
+    Camera(int x, int y) : x(x), y(y) {}
+    int x, y;
+};
+
+struct Input
+{
+    Input() : pressed(false) {}
+    bool pressed;
+};
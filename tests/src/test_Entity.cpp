@@ -54,6 +54,19 @@ TEST(NAME, RemovingNonExistingComponentDoesNothing)
     entity.removeComponent<NonExistingComponent>();
 }
 
+TEST(NAME, ListenersAreRegisteredWithTheCreatingEntityManager)
+{
+    MockEntityManager em;
+    Entity entity("entity", &em);
+    EntityListener listener;
+
+    EXPECT_CALL(em, addEntityListener(entity.getID(), &listener)).Times(1);
+    EXPECT_CALL(em, removeEntityListener(entity.getID(), &listener)).Times(1);
+
+    entity.addListener(&listener);
+    entity.removeListener(&listener);
+}
+
 TEST(NAME, EntityDestructionInformsEntityManagerAboutComponentRemoval)
 {
     MockEntityManager em;
@@ -94,6 +107,97 @@ TEST(NAME, CheckForSupportedSystemsUpdatesWhenComponentsAreAddedOrRemoved)
     ASSERT_EQ(true, !entity.supportsSystem(unsupported));
 }
 
+TEST(NAME, EmptyComponentsAreDetectedAsTags)
+{
+    ASSERT_EQ(true, IsTagComponent<TestTag>::value);
+    ASSERT_EQ(true, !IsTagComponent<TestComponent>::value);
+    ASSERT_EQ(true, !IsTagComponent<None>::value);
+}
+
+TEST(NAME, AddingAndRemovingTagsUpdatesSignature)
+{
+    MockEntityManager em;
+    Entity entity("entity", &em);
+
+    // tags still dispatch events, they just aren't allocated
+    EXPECT_CALL(em, informAddComponentHelper(testing::_, testing::_))
+        .Times(1);
+    EXPECT_CALL(em, informRemoveComponentHelper(testing::_, testing::_))
+        .Times(1);
+
+    ASSERT_EQ(true, !entity.hasComponent<TestTag>());
+    entity.addComponent<TestTag>();
+    ASSERT_EQ(true, entity.hasComponent<TestTag>());
+    ASSERT_EQ(0, entity.m_ComponentMap.size());
+    ASSERT_EQ(0, entity.m_TagOverflow.capacity());
+    entity.removeComponent<TestTag>();
+    ASSERT_EQ(true, !entity.hasComponent<TestTag>());
+}
+
+TEST(NAME, TagsShareOneInstance)
+{
+    MockEntityManager em;
+    Entity entity1("entity1", &em);
+    Entity entity2("entity2", &em);
+
+    // uninteresting calls
+    EXPECT_CALL(em, informAddComponentHelper(testing::_, testing::_)).Times(testing::AtLeast(0));
+    EXPECT_CALL(em, informRemoveComponentHelper(testing::_, testing::_)).Times(testing::AtLeast(0));
+
+    entity1.addComponent<TestTag>();
+    entity2.addComponent<TestTag>();
+    ASSERT_EQ(&entity1.getComponent<TestTag>(), &entity2.getComponent<TestTag>());
+}
+
+TEST(NAME, TagsParticipateInSupportedSystems)
+{
+    MockEntityManager em;
+    TestSystem system; system.supportsComponents<TestComponent, TestTag>();
+    Entity entity("entity", &em);
+
+    // uninteresting calls
+    EXPECT_CALL(em, informAddComponentHelper(testing::_, testing::_)).Times(testing::AtLeast(0));
+    EXPECT_CALL(em, informRemoveComponentHelper(testing::_, testing::_)).Times(testing::AtLeast(0));
+
+    entity.addComponent<TestComponent>(1, 2);
+    ASSERT_EQ(true, !entity.supportsSystem(system));
+    entity.addComponent<TestTag>();
+    ASSERT_EQ(true, entity.supportsSystem(system));
+    entity.removeComponent<TestTag>();
+    ASSERT_EQ(true, !entity.supportsSystem(system));
+}
+
+template <int N>
+struct NumberedTag : public Component {};
+
+template <int N>
+void addNumberedTags(Entity& entity)
+{
+    entity.addComponent< NumberedTag<N> >();
+    addNumberedTags<N - 1>(entity);
+}
+
+template <>
+void addNumberedTags<0>(Entity& entity)
+{
+    entity.addComponent< NumberedTag<0> >();
+}
+
+TEST(NAME, TagsBeyondTheInlineSignatureAreStored)
+{
+    MockEntityManager em;
+    Entity entity("entity", &em);
+
+    // every tag is removed again when the entity is destroyed
+    EXPECT_CALL(em, informAddComponentHelper(testing::_, testing::_)).Times(Entity::InlineTagCount + 16);
+    EXPECT_CALL(em, informRemoveComponentHelper(testing::_, testing::_)).Times(Entity::InlineTagCount + 16);
+
+    addNumberedTags<Entity::InlineTagCount + 15>(entity);
+    ASSERT_EQ(true, entity.hasComponent< NumberedTag<0> >());
+    ASSERT_EQ(true, entity.hasComponent< NumberedTag<Entity::InlineTagCount + 15> >());
+    ASSERT_EQ(true, !entity.hasComponent<TestTag>());
+}
+
 TEST(NAME, ConfiguringEntityCallsSystem)
 {
     World w;
@@ -109,4 +213,39 @@ TEST(NAME, ConfiguringEntityCallsSystem)
     
     entity.configure<TestSystem>();
     entity.configure<TestSystem>("hello");
-}
\ No newline at end of file
+}
+
+TEST(NAME, TypedConfigurationIsStoredWithoutSystemLookup)
+{
+    MockEntityManager em;
+    Entity entity("entity", &em);
+
+    // uninteresting calls
+    EXPECT_CALL(em, informAddComponentHelper(testing::_, testing::_)).Times(testing::AtLeast(0));
+    EXPECT_CALL(em, informRemoveComponentHelper(testing::_, testing::_)).Times(testing::AtLeast(0));
+
+    // the system is deliberately not registered anywhere
+    ASSERT_EQ(false, entity.hasConfiguration<ConfigurableSystem>());
+    entity.addConfiguration<ConfigurableSystem>(2.5f, true);
+    ASSERT_EQ(true, entity.hasConfiguration<ConfigurableSystem>());
+    EXPECT_EQ(2.5f, entity.getConfiguration<ConfigurableSystem>().speed);
+    EXPECT_EQ(true, entity.getConfiguration<ConfigurableSystem>().canJump);
+
+    entity.getConfiguration<ConfigurableSystem>().speed = 3.0f;
+    EXPECT_EQ(3.0f, entity.getComponent< Configuration<ConfigurableSystem> >().config.speed);
+}
+
+TEST(NAME, SystemsCanRequireTheirConfiguration)
+{
+    MockEntityManager em;
+    TestSystem system; system.supportsComponents< Configuration<ConfigurableSystem> >();
+    Entity entity("entity", &em);
+
+    // uninteresting calls
+    EXPECT_CALL(em, informAddComponentHelper(testing::_, testing::_)).Times(testing::AtLeast(0));
+    EXPECT_CALL(em, informRemoveComponentHelper(testing::_, testing::_)).Times(testing::AtLeast(0));
+
+    ASSERT_EQ(true, !entity.supportsSystem(system));
+    entity.addConfiguration<ConfigurableSystem>();
+    ASSERT_EQ(true, entity.supportsSystem(system));
+}
@@ -106,6 +106,58 @@ TEST(NAME, AddingAndRemovingComponentsDispatchesEvents)
     em.event.removeListener("mock");
 }
 
+TEST(NAME, ComponentListenersOnlyReceiveTheirTypes)
+{
+    World w;
+    MockEntityManagerListener mock;
+    EntityManager em(&w);
+    em.addComponentListener<TestComponent>(&mock);
+
+    // filtered listeners receive no entity events
+    EXPECT_CALL(mock, onCreateEntityHelper(testing::_))
+        .Times(0);
+    EXPECT_CALL(mock, onAddComponentHelper(testing::_, testing::Pointee(testing::Eq(TestComponent(336, 743)))))
+        .Times(1);
+    EXPECT_CALL(mock, onRemoveComponentHelper(testing::_, testing::Pointee(testing::Eq(TestComponent(336, 743)))))
+        .Times(1);
+
+    Entity& e = em.createEntity("entity");
+    e.addComponent<SharedComponent>(5);
+    e.addComponent<TestComponent>(336, 743);
+    e.removeComponent<SharedComponent>();
+    e.removeComponent<TestComponent>();
+
+    em.removeComponentListener(&mock);
+    e.addComponent<TestComponent>(1, 2);
+    EXPECT_EQ(0, em.m_ComponentListeners.size());
+}
+
+TEST(NAME, ComponentListenersIgnoreReallocation)
+{
+    World w;
+    MockEntityManagerListener mock;
+    EntityManager em(&w);
+    em.addComponentListener<TestComponent>(&mock);
+
+    // growing the entity list copies entities and destroys the originals,
+    // only the destroyed entity really loses its component
+    EXPECT_CALL(mock, onAddComponentHelper(testing::_, testing::_))
+        .Times(100);
+    EXPECT_CALL(mock, onRemoveComponentHelper(testing::_, testing::_))
+        .Times(1);
+
+    Entity::ID first = 0;
+    for(int i = 0; i != 100; ++i)
+    {
+        Entity& entity = em.createEntity("entity").addComponent<TestComponent>(i, i);
+        if(i == 0)
+            first = entity.getID();
+    }
+    em.destroyEntity(em.getEntity(first));
+
+    em.removeComponentListener(&mock);
+}
+
 TEST(NAME, RemoveComponentEventDispatchesOnDestruction)
 {
     World w;
@@ -172,4 +224,197 @@ TEST(NAME, GetEntityByID)
     ASSERT_EQ(std::string("entity1"), em.getEntity(a).getName());
     ASSERT_EQ(std::string("entity2"), em.getEntity(b).getName());
     ASSERT_EQ(std::string("entity3"), em.getEntity(c).getName());
-}
\ No newline at end of file
+}
+
+TEST(NAME, EntityNamesAreInterned)
+{
+    World w;
+    EntityManager em(&w);
+    std::string name("entity");
+    em.createEntity(name.c_str());
+    em.createEntity("entity");
+
+    // the manager keeps its own copy of the name, so changing the original
+    // string changes nothing
+    name[0] = 'x';
+    ASSERT_EQ(std::string("entity"), em.getEntityList()[0].getName());
+    ASSERT_EQ(em.getEntityList()[0].getName(), em.getEntityList()[1].getName());
+}
+
+TEST(NAME, GetEntityIDsByName)
+{
+    World w;
+    EntityManager em(&w);
+    Entity::ID a = em.createEntity("entity").getID();
+    em.createEntity("other");
+    Entity::ID c = em.createEntity("entity").getID();
+
+    ASSERT_EQ(2, em.getEntityIDs("entity").size());
+    EXPECT_EQ(a, em.getEntityIDs("entity")[0]);
+    EXPECT_EQ(c, em.getEntityIDs("entity")[1]);
+    EXPECT_EQ(0, em.getEntityIDs("never used as a name").size());
+}
+
+TEST(NAME, DestroyingEntitiesKeepsIndicesIntact)
+{
+    World w;
+    EntityManager em(&w);
+    em.createEntity("entity");
+    Entity::ID b = em.createEntity("keep me").getID();
+    em.createEntity("entity");
+    Entity::ID d = em.createEntity("keep me too").getID();
+
+    em.destroyEntities("entity");
+    ASSERT_EQ(2, em.getEntityList().size());
+    EXPECT_EQ(0, em.getEntityIDs("entity").size());
+    EXPECT_EQ(std::string("keep me"), em.getEntity(b).getName());
+    EXPECT_EQ(std::string("keep me too"), em.getEntity(d).getName());
+
+    em.destroyEntity(em.getEntity(b));
+    ASSERT_EQ(1, em.getEntityList().size());
+    EXPECT_EQ(0, em.getEntityIDs("keep me").size());
+    EXPECT_EQ(std::string("keep me too"), em.getEntity(d).getName());
+}
+
+TEST(NAME, NamesAreReleasedWithTheirLastEntity)
+{
+    World w;
+    EntityManager em(&w);
+    for(int i = 0; i != 100; ++i)
+        em.createEntity(("bullet_" + std::to_string(i)).c_str());
+    em.createEntity("player");
+    ASSERT_EQ(101, em.m_NameIndex.size());
+
+    for(int i = 0; i != 100; ++i)
+        em.destroyEntity(em.getEntity(em.getEntityIDs(("bullet_" + std::to_string(i)).c_str())[0]));
+    ASSERT_EQ(1, em.m_NameIndex.size());
+    EXPECT_EQ(std::string("player"), em.getEntityList()[0].getName());
+}
+
+TEST(NAME, SystemsFollowEntitiesMovedByDestruction)
+{
+    World w;
+    w.getSystemManager().addSystem<CollectingSystem>()
+        .supportsComponents<TestComponent>();
+    w.getSystemManager().initialise();
+    for(int i = 0; i != 6; ++i)
+        w.getEntityManager().createEntity(i % 2 ? "odd" : "even").addComponent<TestComponent>(i, 0);
+
+    // the last entities take the places of the destroyed ones
+    w.getEntityManager().destroyEntities("even");
+    w.update();
+    std::vector<int> values = w.getSystemManager().getSystem<CollectingSystem>().values;
+    std::sort(values.begin(), values.end());
+    EXPECT_EQ(std::vector<int>({1, 3, 5}), values);
+}
+
+TEST(NAME, SharedComponentsAreDeduplicated)
+{
+    World w;
+    EntityManager& em = w.getEntityManager();
+    Entity::ID a = em.createEntity("a").addSharedComponent<SharedComponent>(3).getID();
+    Entity::ID b = em.createEntity("b").addSharedComponent<SharedComponent>(3).getID();
+    Entity::ID c = em.createEntity("c").addSharedComponent<SharedComponent>(4).getID();
+
+    ASSERT_EQ(&em.getEntity(a).getSharedComponent<SharedComponent>(), &em.getEntity(b).getSharedComponent<SharedComponent>());
+    ASSERT_NE(&em.getEntity(a).getSharedComponent<SharedComponent>(), &em.getEntity(c).getSharedComponent<SharedComponent>());
+    ASSERT_EQ(4, em.getEntity(c).getSharedComponent<SharedComponent>().value);
+    ASSERT_EQ(2, em.getSharedComponentPool().count<SharedComponent>());
+}
+
+TEST(NAME, SharedComponentsAreReleasedWithLastEntity)
+{
+    World w;
+    EntityManager& em = w.getEntityManager();
+    em.createEntity("a").addSharedComponent<SharedComponent>(3);
+    em.createEntity("b").addSharedComponent<SharedComponent>(3);
+    ASSERT_EQ(1, em.getSharedComponentPool().count<SharedComponent>());
+
+    em.destroyEntities("a");
+    ASSERT_EQ(1, em.getSharedComponentPool().count<SharedComponent>());
+    em.destroyEntities("b");
+    ASSERT_EQ(0, em.getSharedComponentPool().count<SharedComponent>());
+}
+
+TEST(NAME, HashableSharedComponentsAreDeduplicated)
+{
+    World w;
+    EntityManager& em = w.getEntityManager();
+    for(int i = 0; i != 100; ++i)
+        em.createEntity("entity").addSharedComponent<HashableSharedComponent>(i % 10);
+    ASSERT_EQ(10, em.getSharedComponentPool().count<HashableSharedComponent>());
+    ASSERT_EQ(&em.getEntityList()[3].getSharedComponent<HashableSharedComponent>(),
+              &em.getEntityList()[13].getSharedComponent<HashableSharedComponent>());
+}
+
+TEST(NAME, ReleasedSharedComponentsLeaveNoBuckets)
+{
+    World w;
+    EntityManager& em = w.getEntityManager();
+    for(int i = 0; i != 100; ++i)
+        em.createEntity("entity").addSharedComponent<HashableSharedComponent>(i);
+    ASSERT_EQ(100, em.getSharedComponentPool().bucketCount<HashableSharedComponent>());
+
+    em.destroyEntities("entity");
+    ASSERT_EQ(0, em.getSharedComponentPool().count<HashableSharedComponent>());
+    ASSERT_EQ(0, em.getSharedComponentPool().bucketCount<HashableSharedComponent>());
+}
+
+TEST(NAME, SharedComponentsUseThePoolOfTheEntitysManager)
+{
+    World w;
+    EntityManager em(&w);
+    em.createEntity("a").addSharedComponent<SharedComponent>(3);
+    ASSERT_EQ(1, em.getSharedComponentPool().count<SharedComponent>());
+    ASSERT_EQ(0, w.getEntityManager().getSharedComponentPool().count<SharedComponent>());
+}
+
+TEST(NAME, EntityListenersAreNotifiedInBatch)
+{
+    World w;
+    RecordingEntityListener listener;
+    EntityManager& em = w.getEntityManager();
+    Entity::ID observed = em.createEntity("observed").addListener(&listener).getID();
+    em.createEntity("other").addComponent<TestComponent>(1, 1);
+
+    em.getEntity(observed).addComponent<TestComponent>(2, 2);
+    em.getEntity(observed).removeComponent<TestComponent>();
+    EXPECT_EQ(0, listener.events.size());
+
+    // the removed component is kept alive until the listener saw it
+    em.dispatchEntityEvents();
+    EXPECT_EQ(std::vector<std::string>({"add 2", "remove 2"}), listener.events);
+}
+
+TEST(NAME, EntityListenersAreReleasedOnDestruction)
+{
+    World w;
+    RecordingEntityListener listener;
+    EntityManager& em = w.getEntityManager();
+    Entity::ID observed = em.createEntity("observed")
+        .addComponent<TestComponent>(1, 1)
+        .addListener(&listener)
+        .getID();
+
+    // entities relocated by growing or shrinking the list don't report
+    // removed components
+    for(int i = 0; i != 100; ++i)
+        em.createEntity("other");
+    em.destroyEntities("other");
+    em.destroyEntity(em.getEntity(observed));
+    em.dispatchEntityEvents();
+    EXPECT_EQ(std::vector<std::string>({"destroy"}), listener.events);
+    EXPECT_EQ(0, em.m_EntityListeners.size());
+}
+
+TEST(NAME, RemovingEntityListenersDiscardsQueuedEvents)
+{
+    World w;
+    RecordingEntityListener listener;
+    EntityManager& em = w.getEntityManager();
+    Entity& entity = em.createEntity("observed").addListener(&listener);
+    entity.addComponent<TestComponent>(1, 1);
+    entity.removeListener(&listener);
+    em.dispatchEntityEvents();
+    EXPECT_EQ(0, listener.events.size());
+}
@@ -38,4 +38,18 @@ TEST(NAME, GettingNonExistingComponentsThrowsInvalidComponentException)
     ASSERT_THROW(entity.getComponent<NonExistingComponent>(), InvalidComponentException);
 }
 
+TEST(NAME, ModifyingSharedComponentsThrowsSharedComponentException)
+{
+    MockEntityManager em;
+    Entity entity("entity", &em);
+
+    // uninteresting calls
+    EXPECT_CALL(em, informRemoveComponentHelper(testing::_, testing::_)).Times(testing::AtLeast(0));
+    EXPECT_CALL(em, informAddComponentHelper(testing::_, testing::_)).Times(testing::AtLeast(0));
+
+    entity.addSharedComponent<TestComponent>(2, 3);
+    ASSERT_EQ(TestComponent(2, 3), entity.getSharedComponent<TestComponent>());
+    ASSERT_THROW(entity.getComponent<TestComponent>(), SharedComponentException);
+}
+
 #endif // TESTS_WITH_EXCEPTIONS
\ No newline at end of file
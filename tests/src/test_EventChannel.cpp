@@ -0,0 +1,134 @@
+#include <gmock/gmock.h>
+#include <ontology/Ontology.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define NAME EventChannel
+
+using namespace Ontology;
+
+struct Collision
+{
+    Collision(int a, int b) : a(a), b(b) {}
+    int a, b;
+};
+
+// ----------------------------------------------------------------------------
+// tests
+// ----------------------------------------------------------------------------
+
+TEST(NAME, EventsAreReadInSendOrder)
+{
+    World world;
+    world.events<Collision>().send(Collision(1, 2));
+    world.events<Collision>().emplace(3, 4);
+
+    const std::vector<Collision>& collisions = world.events<Collision>().get();
+    ASSERT_EQ(2, collisions.size());
+    EXPECT_EQ(1, collisions[0].a);
+    EXPECT_EQ(4, collisions[1].b);
+    EXPECT_EQ(&world.events<Collision>(), &world.events<Collision>());
+}
+
+TEST(NAME, EventsMoveToPreviousFrameOnUpdate)
+{
+    World world;
+    world.getSystemManager().initialise();
+    world.events<Collision>().emplace(1, 2);
+
+    world.update();
+    EXPECT_EQ(0, world.events<Collision>().get().size());
+    ASSERT_EQ(1, world.events<Collision>().getPrevious().size());
+    EXPECT_EQ(1, world.events<Collision>().getPrevious()[0].a);
+
+    world.update();
+    EXPECT_EQ(0, world.events<Collision>().getPrevious().size());
+}
+
+TEST(NAME, ChannelsAreSeparatedByType)
+{
+    World world;
+    world.events<Collision>().emplace(1, 2);
+    world.events<int>().send(5);
+    EXPECT_EQ(1, world.events<Collision>().get().size());
+    ASSERT_EQ(1, world.events<int>().get().size());
+    EXPECT_EQ(5, world.events<int>().get()[0]);
+}
+
+TEST(NAME, EventsPostedFromThreadsAreFlushedOnUpdate)
+{
+    World world;
+    world.getSystemManager().initialise();
+    EventChannel<int>& channel = world.events<int>();
+
+    std::vector<std::thread> threads;
+    for(int t = 0; t != 4; ++t)
+        threads.emplace_back([&channel, t]() {
+            for(int i = 0; i != 1000; ++i)
+                channel.post(t * 1000 + i);
+        });
+    for(auto& thread : threads)
+        thread.join();
+    EXPECT_EQ(0, channel.get().size());
+
+    // the events are flushed at the start and moved to the previous frame
+    // at the end of the update
+    world.update();
+    std::vector<int> events = channel.getPrevious();
+    ASSERT_EQ(4000, events.size());
+
+    // events posted by the same thread keep their order
+    std::vector<int> last(4, -1);
+    for(int event : events)
+    {
+        EXPECT_LT(last[event / 1000], event);
+        last[event / 1000] = event;
+    }
+}
+
+TEST(NAME, EventsPostedDuringUpdatesAreNotLost)
+{
+    World world;
+    world.getSystemManager().initialise();
+    EventChannel<std::string>& channel = world.events<std::string>();
+
+    std::atomic<bool> done(false);
+    std::thread thread([&channel, &done]() {
+        for(int i = 0; i != 10000; ++i)
+            channel.post(std::to_string(i));
+        done = true;
+    });
+
+    std::vector<std::string> events;
+    while(!done)
+    {
+        world.update();
+        events.insert(events.end(), channel.getPrevious().begin(), channel.getPrevious().end());
+    }
+    thread.join();
+    world.update();
+    events.insert(events.end(), channel.getPrevious().begin(), channel.getPrevious().end());
+
+    ASSERT_EQ(10000, events.size());
+    for(int i = 0; i != 10000; ++i)
+        EXPECT_EQ(std::to_string(i), events[i]);
+}
+
+TEST(NAME, ChannelsRequestedFromThreadsAreShared)
+{
+    World world;
+    std::vector<EventChannel<Collision>*> channels(4, nullptr);
+    std::vector<std::thread> threads;
+    for(int t = 0; t != 4; ++t)
+        threads.emplace_back([&world, &channels, t]() {
+            channels[t] = &world.events<Collision>();
+        });
+    for(auto& thread : threads)
+        thread.join();
+
+    for(const auto& channel : channels)
+        EXPECT_EQ(&world.events<Collision>(), channel);
+}
@@ -0,0 +1,75 @@
+#include <gmock/gmock.h>
+#include <ontology/FrameAllocator.hpp>
+#include <ontology/World.hpp>
+
+#include <cstdint>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#define NAME FrameAllocator
+
+using namespace Ontology;
+
+// ----------------------------------------------------------------------------
+// tests
+// ----------------------------------------------------------------------------
+
+TEST(NAME, AllocationsAreAligned)
+{
+    LinearArena arena(256);
+    arena.allocate(1, 1);
+    EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(arena.allocate<double>(1)) % alignof(double));
+    arena.allocate(3, 1);
+    EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(arena.allocate(8, 64)) % 64);
+}
+
+TEST(NAME, BlocksAreMergedOnReset)
+{
+    LinearArena arena(64);
+    for(int i = 0; i != 10; ++i)
+        arena.allocate(48, 1);
+    EXPECT_LT(1, arena.m_Blocks.size());
+
+    const std::size_t capacity = arena.getCapacity();
+    arena.reset();
+    EXPECT_EQ(0, arena.getUsed());
+    EXPECT_EQ(1, arena.m_Blocks.size());
+    EXPECT_EQ(capacity, arena.getCapacity());
+
+    // the same amount of memory now fits into the merged block
+    for(int i = 0; i != 10; ++i)
+        arena.allocate(48, 1);
+    EXPECT_EQ(1, arena.m_Blocks.size());
+}
+
+TEST(NAME, ThreadsAllocateFromTheirOwnArena)
+{
+    FrameAllocator allocator;
+    LinearArena* mainArena = &allocator.local();
+    LinearArena* otherArena = nullptr;
+    std::thread thread([&]() { otherArena = &allocator.local(); });
+    thread.join();
+
+    EXPECT_EQ(mainArena, &allocator.local());
+    EXPECT_NE(mainArena, otherArena);
+}
+
+TEST(NAME, ArenaAllocatorWorksWithContainers)
+{
+    LinearArena arena;
+    std::vector<int, ArenaAllocator<int> > values(arena);
+    for(int i = 0; i != 1000; ++i)
+        values.push_back(i);
+    EXPECT_EQ(499500, std::accumulate(values.begin(), values.end(), 0));
+    EXPECT_LE(1000 * sizeof(int), arena.getUsed());
+}
+
+TEST(NAME, WorldResetsFrameAllocatorAfterUpdate)
+{
+    World world;
+    world.getFrameAllocator().local().allocate<float>(100);
+    EXPECT_LT(0, world.getFrameAllocator().getUsed());
+    world.update();
+    EXPECT_EQ(0, world.getFrameAllocator().getUsed());
+}
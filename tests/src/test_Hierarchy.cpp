@@ -0,0 +1,86 @@
+#include <gmock/gmock.h>
+#include <ontology/Ontology.hpp>
+
+#include <vector>
+
+#define NAME Hierarchy
+
+using namespace Ontology;
+
+// ----------------------------------------------------------------------------
+// tests
+// ----------------------------------------------------------------------------
+
+TEST(NAME, NodesAreSortedByDepth)
+{
+    Hierarchy hierarchy;
+    hierarchy.setParent(3, 2);
+    hierarchy.setParent(2, 1);
+    hierarchy.setParent(4, 1);
+    hierarchy.setParent(5, 3);
+
+    const std::vector<Hierarchy::Node>& nodes = hierarchy.getNodes();
+    ASSERT_EQ(5, nodes.size());
+    EXPECT_EQ(4, hierarchy.getLevelCount());
+    for(std::size_t index = 1; index != nodes.size(); ++index)
+    {
+        EXPECT_LE(nodes[index - 1].depth, nodes[index].depth);
+        EXPECT_LT(nodes[index].parentIndex, index);
+        EXPECT_EQ(nodes[index].parent, nodes[nodes[index].parentIndex].entity);
+    }
+    EXPECT_EQ(1, nodes[0].entity);
+    EXPECT_EQ(5, nodes[4].entity);
+    EXPECT_EQ(1, hierarchy.getLevelBegin(1));
+    EXPECT_EQ(3, hierarchy.getLevelBegin(2));
+}
+
+TEST(NAME, ReparentingMovesSubtree)
+{
+    Hierarchy hierarchy;
+    hierarchy.setParent(2, 1);
+    hierarchy.setParent(3, 2);
+    hierarchy.setParent(4, 1);
+    hierarchy.setParent(2, 4);
+
+    EXPECT_EQ(std::vector<Entity::ID>({4}), hierarchy.getChildren(1));
+    EXPECT_EQ(4, hierarchy.getParent(2));
+    EXPECT_EQ(3, hierarchy.getNodes()[hierarchy.getIndex(3)].depth);
+
+    hierarchy.removeParent(2);
+    EXPECT_EQ(Hierarchy::InvalidID, hierarchy.getParent(2));
+    EXPECT_EQ(0, hierarchy.getNodes()[hierarchy.getIndex(2)].depth);
+}
+
+TEST(NAME, PropagateVisitsParentsFirst)
+{
+    ThreadPool pool(4);
+    Hierarchy hierarchy;
+    for(Entity::ID id = 1; id != 5000; ++id)
+        hierarchy.setParent(id, id / 4);
+
+    // every node accumulates the depth of its parent
+    std::vector<int> depth(hierarchy.getNodes().size(), 0);
+    hierarchy.propagate([&depth](std::size_t index, std::size_t parentIndex) {
+        depth[index] = depth[parentIndex] + 1;
+    }, &pool, 64);
+
+    const std::vector<Hierarchy::Node>& nodes = hierarchy.getNodes();
+    for(std::size_t index = 0; index != nodes.size(); ++index)
+        EXPECT_EQ(nodes[index].depth, depth[index]);
+}
+
+TEST(NAME, DestroyedEntitiesAreRemoved)
+{
+    World world;
+    Entity::ID parent = world.getEntityManager().createEntity("parent").getID();
+    Entity::ID child = world.getEntityManager().createEntity("child").getID();
+    Entity::ID grandChild = world.getEntityManager().createEntity("grandChild").getID();
+    world.getHierarchy().setParent(child, parent);
+    world.getHierarchy().setParent(grandChild, child);
+
+    world.getEntityManager().destroyEntity(world.getEntityManager().getEntity(child));
+    EXPECT_FALSE(world.getHierarchy().contains(child));
+    EXPECT_EQ(0, world.getHierarchy().getChildren(parent).size());
+    EXPECT_EQ(Hierarchy::InvalidID, world.getHierarchy().getParent(grandChild));
+    EXPECT_EQ(1, world.getHierarchy().getLevelCount());
+}
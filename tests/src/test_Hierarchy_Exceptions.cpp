@@ -0,0 +1,42 @@
+#include <tests/Config.hpp>
+#include <gmock/gmock.h>
+#include <ontology/Ontology.hpp>
+
+#include <string>
+#include <vector>
+
+#define NAME Hierarchy
+
+using namespace Ontology;
+
+#ifdef TESTS_WITH_EXCEPTIONS
+
+// ----------------------------------------------------------------------------
+// tests
+// ----------------------------------------------------------------------------
+
+TEST(NAME, ParentingAnAncestorThrowsInvalidParentException)
+{
+    Hierarchy hierarchy;
+    hierarchy.setParent(2, 1);
+    hierarchy.setParent(3, 2);
+    ASSERT_THROW(hierarchy.setParent(1, 3), InvalidParentException);
+    ASSERT_THROW(hierarchy.setParent(1, 1), InvalidParentException);
+}
+
+TEST(NAME, ParentingAnAncestorIsLoggedAndIgnored)
+{
+    std::vector<std::string> messages;
+    World world;
+    world.setLogger([&messages](const std::string& message) {
+        messages.push_back(message);
+    });
+    world.getHierarchy().setParent(2, 1);
+    ASSERT_THROW(world.getHierarchy().setParent(1, 2), InvalidParentException);
+
+    EXPECT_EQ(1, messages.size());
+    EXPECT_EQ(Hierarchy::InvalidID, world.getHierarchy().getParent(1));
+    EXPECT_EQ(1, world.getHierarchy().getParent(2));
+}
+
+#endif // TESTS_WITH_EXCEPTIONS
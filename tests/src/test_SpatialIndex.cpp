@@ -0,0 +1,168 @@
+#include <gmock/gmock.h>
+#include <ontology/Ontology.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#define NAME SpatialIndex
+
+using namespace Ontology;
+
+struct Location : public Component
+{
+    Location(float x, float y) : x(x), y(y) {}
+    float x, y;
+};
+
+// ----------------------------------------------------------------------------
+// tests
+// ----------------------------------------------------------------------------
+
+TEST(NAME, QueriesMatchBruteForce)
+{
+    World world;
+    world.addSpatialIndex<Location>(4.0f, [](const Location& location) {
+        return SpatialIndex::Point(location.x, location.y);
+    });
+    world.getEntityManager().createEntity("no location");
+    for(int i = 0; i != 500; ++i)
+        world.getEntityManager().createEntity("entity")
+            .addComponent<Location>(float((i * 37) % 101) - 50.0f, float((i * 53) % 97) - 48.0f);
+
+    const SpatialIndex::Point center(3.0f, -7.0f);
+    const float radius = 11.0f;
+    std::vector<Entity::ID> expectedRadius, expectedBox;
+    for(const auto& entity : world.getEntityManager().getEntityList())
+    {
+        if(!entity.hasComponent<Location>())
+            continue;
+        const Location& location = entity.getComponent<Location>();
+        const float dx = location.x - center.x, dy = location.y - center.y;
+        if(dx*dx + dy*dy <= radius*radius)
+            expectedRadius.push_back(entity.getID());
+        if(location.x >= -20 && location.x <= 5 && location.y >= 0 && location.y <= 30)
+            expectedBox.push_back(entity.getID());
+    }
+
+    std::vector<Entity::ID> result = world.queryRadius(center, radius);
+    std::sort(result.begin(), result.end());
+    EXPECT_EQ(expectedRadius, result);
+    EXPECT_LT(0, result.size());
+
+    result = world.queryAABB(SpatialIndex::Point(-20, 0), SpatialIndex::Point(5, 30));
+    std::sort(result.begin(), result.end());
+    EXPECT_EQ(expectedBox, result);
+
+    // boxes larger than the world are scanned entry by entry
+    EXPECT_EQ(500, world.queryAABB(SpatialIndex::Point(-1e6f, -1e6f), SpatialIndex::Point(1e6f, 1e6f)).size());
+}
+
+TEST(NAME, IndexIsRebuiltWhenPositionsChange)
+{
+    World world;
+    world.addSpatialIndex<Location>(1.0f, [](const Location& location) {
+        return SpatialIndex::Point(location.x, location.y);
+    });
+    Entity::ID id = world.getEntityManager().createEntity("entity")
+        .addComponent<Location>(0.0f, 0.0f)
+        .getID();
+    EXPECT_EQ(1, world.queryRadius(SpatialIndex::Point(), 0.5f).size());
+
+    // unflagged modifications aren't picked up
+    world.getEntityManager().getEntity(id).getComponent<Location>().x = 10.0f;
+    EXPECT_EQ(1, world.queryRadius(SpatialIndex::Point(), 0.5f).size());
+
+    world.markChanged<Location>();
+    EXPECT_EQ(0, world.queryRadius(SpatialIndex::Point(), 0.5f).size());
+    EXPECT_EQ(1, world.queryRadius(SpatialIndex::Point(10.0f, 0.0f), 0.5f).size());
+
+    world.getEntityManager().getEntity(id).removeComponent<Location>();
+    EXPECT_EQ(0, world.queryRadius(SpatialIndex::Point(10.0f, 0.0f), 0.5f).size());
+}
+
+TEST(NAME, ConcurrentQueriesDontObserveRebuilds)
+{
+    World world;
+    world.addSpatialIndex<Location>(2.0f, [](const Location& location) {
+        return SpatialIndex::Point(location.x, location.y);
+    });
+    for(int i = 0; i != 200; ++i)
+        world.getEntityManager().createEntity("entity")
+            .addComponent<Location>(float(i % 20), float(i / 20));
+    const std::size_t expected = world.queryAABB(SpatialIndex::Point(0, 0), SpatialIndex::Point(9, 9)).size();
+
+    // every query flags the positions as changed, so the next one rebuilds
+    // the grid while others may still be reading it
+    std::atomic<int> mismatches(0);
+    std::vector<std::thread> threads;
+    for(int t = 0; t != 4; ++t)
+        threads.emplace_back([&world, &mismatches, expected]() {
+            for(int i = 0; i != 200; ++i)
+            {
+                world.markChanged<Location>();
+                if(world.queryAABB(SpatialIndex::Point(0, 0), SpatialIndex::Point(9, 9)).size() != expected)
+                    ++mismatches;
+            }
+        });
+    for(auto& thread : threads)
+        thread.join();
+    EXPECT_EQ(0, mismatches.load());
+}
+
+TEST(NAME, EntitiesAreReorderedByPositionOverSeveralUpdates)
+{
+    World world;
+    world.addSpatialIndex<Location>(1.0f, [](const Location& location) {
+        return SpatialIndex::Point(location.x, location.y);
+    }).setReorderBudget(16);
+    for(int i = 0; i != 100; ++i)
+        world.getEntityManager().createEntity("entity").addComponent<Location>(float((i * 37) % 100), 0.0f);
+    world.getSystemManager().initialise();
+
+    for(int i = 0; i != 100; ++i)
+        world.update();
+
+    // moving entities must not detach IDs from them
+    const EntityManager::EntityList& entities = world.getEntityManager().getEntityList();
+    ASSERT_EQ(100, entities.size());
+    for(std::size_t i = 0; i != entities.size(); ++i)
+    {
+        EXPECT_EQ(float(i), entities[i].getComponent<Location>().x);
+        EXPECT_EQ(&entities[i], &world.getEntityManager().getEntity(entities[i].getID()));
+    }
+    EXPECT_EQ(1, world.queryRadius(SpatialIndex::Point(42.0f, 0.0f), 0.5f).size());
+}
+
+TEST(NAME, ReorderingKeepsTheOrderOfSortedSystems)
+{
+    struct RecordingSystem : public System
+    {
+        void initialise() override {}
+        void processEntity(Entity& entity) override { order.push_back(entity.getComponent<Location>().y); }
+        void configureEntity(Entity&, std::string) override {}
+        std::vector<float> order;
+    };
+
+    World world;
+    world.addSpatialIndex<Location>(1.0f, [](const Location& location) {
+        return SpatialIndex::Point(location.x, 0.0f);
+    }).setReorderBudget(16);
+    RecordingSystem& system = world.getSystemManager().addSystem<RecordingSystem>();
+    system.supportsComponents<Location>()
+        .sortsEntitiesBy<Location>([](const Location& location) { return location.y; })
+        .setEntityBudget(20);
+    for(int i = 0; i != 50; ++i)
+        world.getEntityManager().createEntity("entity").addComponent<Location>(float((i * 37) % 50), float(i));
+    world.getSystemManager().initialise();
+
+    // every update moves entities in memory, but the budgeted system keeps
+    // slicing through them in key order
+    std::vector<float> expected;
+    for(int i = 0; i != 200; ++i)
+        expected.push_back(float(i % 50));
+    for(int i = 0; i != 10; ++i)
+        world.update();
+    EXPECT_EQ(expected, system.order);
+}
@@ -0,0 +1,140 @@
+#include <gmock/gmock.h>
+#include <ontology/Ontology.hpp>
+
+#include <memory>
+
+#define NAME StaticWorld
+
+using namespace Ontology;
+
+// ----------------------------------------------------------------------------
+// test fixture
+// ----------------------------------------------------------------------------
+
+namespace {
+
+struct Position { int x, y; };
+struct Velocity { int x, y; };
+struct Health { int value; };
+
+struct MovementSystem
+{
+    typedef After<struct InputSystem> Dependencies;
+    void process(Position& p, const Velocity& v) { p.x += v.x; p.y += v.y; }
+};
+
+struct InputSystem
+{
+    InputSystem() : calls(0) {}
+    void process(Velocity& v) { v.x *= 2; ++calls; }
+    int calls;
+};
+
+struct HealthSystem
+{
+    HealthSystem() : calls(0) {}
+    void process(const Health&) { ++calls; }
+    int calls;
+};
+
+typedef StaticWorld<
+    Components<Position, Velocity, Health>,
+    Systems<MovementSystem, HealthSystem, InputSystem>
+> TestWorld;
+
+struct Resource { std::shared_ptr<int> handle; };
+
+typedef StaticWorld<
+    Components<Resource>,
+    Systems<>
+> ResourceWorld;
+
+} // namespace
+
+// ----------------------------------------------------------------------------
+// tests
+// ----------------------------------------------------------------------------
+
+TEST(NAME, ExecutionOrderRespectsDependencies)
+{
+    bool ordered = std::is_same<
+        TestWorld::ExecutionOrder,
+        TypeList<HealthSystem, InputSystem, MovementSystem>
+    >::value;
+    EXPECT_EQ(true, ordered);
+}
+
+TEST(NAME, SystemsProcessEntitiesWithRequiredComponents)
+{
+    TestWorld world;
+    TestWorld::EntityID moving = world.createEntity();
+    world.addComponent<Position>(moving, 1, 2);
+    world.addComponent<Velocity>(moving, 3, 4);
+    TestWorld::EntityID still = world.createEntity();
+    world.addComponent<Position>(still, 5, 6);
+    world.addComponent<Health>(still, 10);
+
+    world.update();
+
+    // InputSystem runs before MovementSystem and doubles the velocity
+    EXPECT_EQ(7, world.getComponent<Position>(moving).x);
+    EXPECT_EQ(6, world.getComponent<Position>(moving).y);
+    EXPECT_EQ(5, world.getComponent<Position>(still).x);
+    EXPECT_EQ(1, world.getSystem<InputSystem>().calls);
+    EXPECT_EQ(1, world.getSystem<HealthSystem>().calls);
+}
+
+TEST(NAME, RemovedComponentsAndDestroyedEntitiesAreSkipped)
+{
+    TestWorld world;
+    TestWorld::EntityID a = world.createEntity();
+    world.addComponent<Velocity>(a, 1, 1);
+    TestWorld::EntityID b = world.createEntity();
+    world.addComponent<Velocity>(b, 1, 1);
+
+    world.removeComponent<Velocity>(a);
+    world.destroyEntity(b);
+    world.update();
+
+    EXPECT_EQ(false, world.hasComponent<Velocity>(a));
+    EXPECT_EQ(false, world.isAlive(b));
+    EXPECT_EQ(0, world.getSystem<InputSystem>().calls);
+}
+
+TEST(NAME, DestroyedEntityIDsAreReused)
+{
+    TestWorld world;
+    TestWorld::EntityID a = world.createEntity();
+    world.addComponent<Health>(a, 3);
+    world.destroyEntity(a);
+    TestWorld::EntityID b = world.createEntity();
+
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(true, world.isAlive(b));
+    EXPECT_EQ(false, world.hasComponent<Health>(b));
+}
+
+TEST(NAME, DestroyingADestroyedEntityDoesNothing)
+{
+    TestWorld world;
+    TestWorld::EntityID a = world.createEntity();
+    world.destroyEntity(a);
+    world.destroyEntity(a);
+
+    TestWorld::EntityID b = world.createEntity();
+    TestWorld::EntityID c = world.createEntity();
+    EXPECT_EQ(a, b);
+    EXPECT_NE(b, c);
+}
+
+TEST(NAME, DestroyedEntitiesReleaseTheirComponents)
+{
+    std::shared_ptr<int> handle(new int(3));
+    ResourceWorld world;
+    ResourceWorld::EntityID a = world.createEntity();
+    world.addComponent<Resource>(a, handle);
+    EXPECT_EQ(2, handle.use_count());
+
+    world.destroyEntity(a);
+    EXPECT_EQ(1, handle.use_count());
+}
@@ -0,0 +1,47 @@
+#include <tests/Config.hpp>
+#include <gmock/gmock.h>
+#include <ontology/Ontology.hpp>
+
+#define NAME StaticWorld
+
+using namespace Ontology;
+
+#ifdef TESTS_WITH_EXCEPTIONS
+
+// ----------------------------------------------------------------------------
+// test fixture
+// ----------------------------------------------------------------------------
+
+namespace {
+
+struct Health { int value; };
+
+typedef StaticWorld<
+    Components<Health>,
+    Systems<>
+> TestWorld;
+
+} // namespace
+
+// ----------------------------------------------------------------------------
+// tests
+// ----------------------------------------------------------------------------
+
+TEST(NAME, AccessingComponentsOfDestroyedEntitiesThrowsInvalidEntityException)
+{
+    TestWorld world;
+    TestWorld::EntityID a = world.createEntity();
+    world.addComponent<Health>(a, 3);
+    world.destroyEntity(a);
+    ASSERT_THROW(world.addComponent<Health>(a, 3), InvalidEntityException);
+    ASSERT_THROW(world.getComponent<Health>(a), InvalidEntityException);
+}
+
+TEST(NAME, AccessingComponentsOfUnknownEntitiesThrowsInvalidEntityException)
+{
+    TestWorld world;
+    ASSERT_THROW(world.addComponent<Health>(5, 3), InvalidEntityException);
+    ASSERT_THROW(world.getComponent<Health>(5), InvalidEntityException);
+}
+
+#endif // TESTS_WITH_EXCEPTIONS
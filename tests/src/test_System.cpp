@@ -35,6 +35,10 @@ class TestEntityManager : public EntityManagerInterface
     void destroyAllEntities() override {}
     void informAddComponent(Entity&, const Component*) const override {}
     void informRemoveComponent(Entity&, const Component*) const override {}
+    void addEntityListener(Entity::ID, EntityListener*) const override {}
+    void removeEntityListener(Entity::ID, EntityListener*) const override {}
+    SharedComponentPool& getSharedComponentPool() const override { return pool; }
+    mutable SharedComponentPool pool;
 public:
     TestEntityManager() : EntityManagerInterface(&w), e("dont_call_this", this) {}
 };
@@ -47,6 +51,12 @@ struct NonDependingSystem : public System { OVERRIDE_NECESSARY };
 struct SupportedComponent1 : public Component {};
 struct SupportedComponent2 : public Component {};
 struct UnsupportedComponent : public Component {};
+struct SharedComponent : public Component
+{
+    SharedComponent(int value) : value(value) {}
+    int value;
+    bool operator==(const SharedComponent& other) const { return value == other.value; }
+};
 
 // ----------------------------------------------------------------------------
 // tests
@@ -85,6 +95,19 @@ TEST(NAME, ReceivesDependingSystems)
     ASSERT_EQ(system.getDependingSystems().end(), system.getDependingSystems().find(&typeid(NonDependingSystem)));
 }
 
+TEST(NAME, ReceivesAccessDeclarations)
+{
+    MockSystem system;
+    system
+        .reads<SupportedComponent1>()
+        .writes<SupportedComponent2>();
+
+    ASSERT_NE(system.getReadTypes().end(), system.getReadTypes().find(&typeid(SupportedComponent1)));
+    ASSERT_EQ(system.getReadTypes().end(), system.getReadTypes().find(&typeid(SupportedComponent2)));
+    ASSERT_NE(system.getWriteTypes().end(), system.getWriteTypes().find(&typeid(SupportedComponent2)));
+    ASSERT_EQ(system.getWriteTypes().end(), system.getWriteTypes().find(&typeid(SupportedComponent1)));
+}
+
 TEST(NAME, AcceptsSupportedEntities)
 {
     MockSystem system;
@@ -185,4 +208,136 @@ TEST(NAME, UpdatingSystemCallsInheritingClass)
     
     EXPECT_CALL(system, processEntity(testing::_));
     system.update();
-}
\ No newline at end of file
+}
+
+TEST(NAME, GroupsEntitiesBySharedComponent)
+{
+    World world;
+    MockSystem system;
+    system.supportsComponents<SharedComponent>();
+    system.groupsBySharedComponent<SharedComponent>();
+
+    std::vector<Entity> entityList;
+    for(int i = 0; i != 6; ++i)
+        entityList.push_back(Entity("entity", &world.getEntityManager()));
+    for(int i = 0; i != 6; ++i)
+    {
+        entityList[i].addSharedComponent<SharedComponent>(i % 2);
+        system.informEntityUpdate(entityList[i]);
+    }
+
+    std::vector<const SharedComponent*> processed;
+    EXPECT_CALL(system, processEntity(testing::_))
+        .Times(6)
+        .WillRepeatedly(testing::Invoke([&processed](Entity& e) {
+            processed.push_back(&e.getSharedComponent<SharedComponent>());
+        }));
+    system.update();
+
+    // every shared value is processed as one contiguous batch
+    ASSERT_EQ(6, processed.size());
+    int changes = 0;
+    for(std::size_t i = 1; i != processed.size(); ++i)
+        if(processed[i] != processed[i-1])
+            ++changes;
+    ASSERT_EQ(1, changes);
+}
+
+TEST(NAME, EntityBudgetProcessesRotatingSlices)
+{
+    World world;
+    MockSystem system;
+    system.supportsComponents<SupportedComponent1>();
+    system.setEntityBudget(2);
+
+    std::vector<Entity> entityList;
+    for(int i = 0; i != 5; ++i)
+        entityList.push_back(Entity("entity", &world.getEntityManager()));
+    for(auto& entity : entityList)
+    {
+        entity.addComponent<SupportedComponent1>();
+        system.informEntityUpdate(entity);
+    }
+
+    std::vector<Entity*> processed;
+    EXPECT_CALL(system, processEntity(testing::_))
+        .Times(6)
+        .WillRepeatedly(testing::Invoke([&processed](Entity& e) {
+            processed.push_back(&e);
+        }));
+    system.update();
+    system.update();
+    system.update();
+
+    // resumes where the previous update left off and wraps around
+    ASSERT_EQ(6, processed.size());
+    for(int i = 0; i != 6; ++i)
+        EXPECT_EQ(&entityList[i % 5], processed[i]);
+}
+
+TEST(NAME, TimeBudgetNeverProcessesAnEntityTwicePerUpdate)
+{
+    World world;
+    MockSystem system;
+    system.supportsComponents<SupportedComponent1>();
+    system.setTimeBudget(std::chrono::microseconds(1000000));
+
+    std::vector<Entity> entityList;
+    for(int i = 0; i != 3; ++i)
+        entityList.push_back(Entity("entity", &world.getEntityManager()));
+    for(auto& entity : entityList)
+    {
+        entity.addComponent<SupportedComponent1>();
+        system.informEntityUpdate(entity);
+    }
+
+    EXPECT_CALL(system, processEntity(testing::_))
+        .Times(3);
+    system.update();
+}
+
+TEST(NAME, CheapSystemsAreProcessedSerially)
+{
+    World world;
+    world.getThreadPool().setThreadCount(4);
+    MockSystem& system = world.getSystemManager().addSystem<MockSystem>();
+
+    // systems are serial unless they opt in
+    system.m_CostPerEntity = 100000.0;
+    EXPECT_EQ(0, system.chooseGrainSize(50));
+
+    system.setExecutionPolicy(ExecutionPolicy::Automatic);
+    system.m_CostPerEntity = 100.0;
+    EXPECT_EQ(0, system.chooseGrainSize(50));
+
+    system.m_CostPerEntity = 100000.0;
+    EXPECT_LT(0, system.chooseGrainSize(50));
+    system.setExecutionPolicy(ExecutionPolicy::Serial);
+    EXPECT_EQ(0, system.chooseGrainSize(50));
+}
+
+TEST(NAME, ParallelSystemsProcessEveryEntityOnce)
+{
+    World world;
+    world.getThreadPool().setThreadCount(4);
+    MockSystem& system = world.getSystemManager().addSystem<MockSystem>();
+    system.supportsComponents<SupportedComponent1>()
+        .setExecutionPolicy(ExecutionPolicy::Parallel, 3);
+
+    for(int i = 0; i != 20; ++i)
+        world.getEntityManager().createEntity("entity")
+            .addComponent<SupportedComponent1>();
+
+    std::mutex mutex;
+    std::set<Entity*> processed;
+    EXPECT_CALL(system, processEntity(testing::_))
+        .Times(20)
+        .WillRepeatedly(testing::Invoke([&mutex, &processed](Entity& e) {
+            std::lock_guard<std::mutex> guard(mutex);
+            processed.insert(&e);
+        }));
+    system.update();
+
+    EXPECT_EQ(20, processed.size());
+    EXPECT_LT(0.0, system.getCostPerEntity());
+}
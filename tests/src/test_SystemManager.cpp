@@ -1,22 +1,724 @@
-#include <gmock/gmock.h>
-#include <ontology/Ontology.hpp>
-
-#define NAME SystemManager
-
-using namespace Ontology;
-
-// ----------------------------------------------------------------------------
-// test fixture
-// ----------------------------------------------------------------------------
+#include <tests/TestFixture_SystemManager.hpp>
 
 // ----------------------------------------------------------------------------
 // tests
 // ----------------------------------------------------------------------------
 
 // TODO test construction/destruction order
-// TODO test initialisation order
-// TODO test execution order without explicit dependencies
-// TODO test execution order with explicit dependencies
-// TODO test for circular dependencies
 // TODO test for exdeptions
-// TODO test what happens to execution order when removing a system
\ No newline at end of file
+
+TEST(NAME, LambdaSystemsProcessSupportedEntities)
+{
+    World world;
+    world.getSystemManager().addSystem("Move", [](Position& p, const Velocity& v) {
+        p.x += v.x;
+        p.y += v.y;
+    });
+    world.getSystemManager().initialise();
+
+    Entity::ID moving = world.getEntityManager().createEntity("moving")
+        .addComponent<Position>(0, 0)
+        .addComponent<Velocity>(2, 3)
+        .getID();
+    Entity::ID still = world.getEntityManager().createEntity("still")
+        .addComponent<Position>(5, 5)
+        .getID();
+
+    world.update();
+    world.update();
+
+    EXPECT_EQ(4, world.getEntityManager().getEntity(moving).getComponent<Position>().x);
+    EXPECT_EQ(6, world.getEntityManager().getEntity(moving).getComponent<Position>().y);
+    EXPECT_EQ(5, world.getEntityManager().getEntity(still).getComponent<Position>().x);
+}
+
+TEST(NAME, LambdaSystemsDeduceAccessFromParameters)
+{
+    World world;
+    System& system = world.getSystemManager().addSystem("Move", [](Position&, const Velocity&) {});
+
+    EXPECT_EQ(std::string("Move"), system.getName());
+    EXPECT_EQ(2, system.getSupportedComponents().size());
+    ASSERT_EQ(1, system.getWriteTypes().size());
+    EXPECT_EQ(&typeid(Position), *system.getWriteTypes().begin());
+    ASSERT_EQ(1, system.getReadTypes().size());
+    EXPECT_EQ(&typeid(Velocity), *system.getReadTypes().begin());
+}
+
+TEST(NAME, EveryLambdaIsItsOwnSystem)
+{
+    World world;
+    world.getSystemManager().addSystem("First", [](Position&) {});
+    world.getSystemManager().addSystem("Second", [](Position&) {});
+    EXPECT_EQ(2, world.getSystemManager().m_SystemList.size());
+}
+
+static void addOne(Position& p) { p.x += 1; }
+static void addTwo(Position& p) { p.x += 2; }
+
+TEST(NAME, FunctionPointersWithTheSameSignatureAreSeparateSystems)
+{
+    World world;
+    System& first = world.getSystemManager().addSystem("AddOne", &addOne);
+    System& second = world.getSystemManager().addSystem("AddTwo", &addTwo);
+    world.getSystemManager().initialise();
+    EXPECT_NE(first.getTypeID(), second.getTypeID());
+
+    Entity::ID entity = world.getEntityManager().createEntity("entity")
+        .addComponent<Position>(0, 0)
+        .getID();
+    world.update();
+
+    EXPECT_EQ(3, world.getEntityManager().getEntity(entity).getComponent<Position>().x);
+}
+
+TEST(NAME, LambdaSystemsSeeReplacedComponents)
+{
+    World world;
+    world.getSystemManager().addSystem("Move", [](Position& p, const Velocity& v) {
+        p.x += v.x;
+    });
+    world.getSystemManager().initialise();
+
+    Entity& entity = world.getEntityManager().createEntity("entity")
+        .addComponent<Position>(0, 0)
+        .addComponent<Velocity>(1, 0);
+    const Entity::ID id = entity.getID();
+    world.update();
+
+    world.getEntityManager().getEntity(id).removeComponent<Velocity>();
+    world.getEntityManager().getEntity(id).addComponent<Velocity>(5, 0);
+    world.update();
+
+    EXPECT_EQ(6, world.getEntityManager().getEntity(id).getComponent<Position>().x);
+}
+
+TEST(NAME, LambdaSystemsReadSharedComponents)
+{
+    World world;
+    world.getSystemManager().addSystem("Slow", [](Velocity& v, const Friction& f) {
+        v.x -= f.value;
+    });
+    world.getSystemManager().initialise();
+
+    const Entity::ID a = world.getEntityManager().createEntity("a")
+        .addComponent<Velocity>(10, 0)
+        .addSharedComponent<Friction>(2)
+        .getID();
+    const Entity::ID b = world.getEntityManager().createEntity("b")
+        .addComponent<Velocity>(20, 0)
+        .addSharedComponent<Friction>(2)
+        .getID();
+    world.update();
+
+    EXPECT_EQ(8, world.getEntityManager().getEntity(a).getComponent<Velocity>().x);
+    EXPECT_EQ(18, world.getEntityManager().getEntity(b).getComponent<Velocity>().x);
+}
+
+TEST(NAME, ExecutionOrderWithoutDependenciesIsInsertionOrder)
+{
+    World world;
+    System& c = world.getSystemManager().addSystem<SystemC>();
+    System& a = world.getSystemManager().addSystem<SystemA>();
+    System& b = world.getSystemManager().addSystem<SystemB>();
+    world.getSystemManager().initialise();
+
+    const std::vector<System*>& order = world.getSystemManager().m_ExecutionList;
+    ASSERT_EQ(3, order.size());
+    EXPECT_EQ(&c, order[0]);
+    EXPECT_EQ(&a, order[1]);
+    EXPECT_EQ(&b, order[2]);
+}
+
+TEST(NAME, ExecutionOrderRespectsDependencies)
+{
+    World world;
+    System& a = world.getSystemManager().addSystem<SystemA>()
+        .executesAfter<SystemC, SystemB>();
+    System& b = world.getSystemManager().addSystem<SystemB>()
+        .executesAfter<SystemC>();
+    System& c = world.getSystemManager().addSystem<SystemC>();
+    System& d = world.getSystemManager().addSystem<SystemD>();
+    world.getSystemManager().initialise();
+
+    const std::vector<System*>& order = world.getSystemManager().m_ExecutionList;
+    ASSERT_EQ(4, order.size());
+    EXPECT_EQ(&c, order[0]);
+    EXPECT_EQ(&d, order[1]);
+    EXPECT_EQ(&b, order[2]);
+    EXPECT_EQ(&a, order[3]);
+}
+
+TEST(NAME, RemovedSystemsLeaveExecutionOrderOnNextUpdate)
+{
+    World world;
+    world.getSystemManager().addSystem<SystemA>();
+    System& b = world.getSystemManager().addSystem<SystemB>();
+    world.getSystemManager().initialise();
+    world.getSystemManager().removeSystem<SystemA>();
+    world.update();
+
+    EXPECT_EQ(false, world.getSystemManager().hasSystem<SystemA>());
+    EXPECT_EQ(&b, &world.getSystemManager().getSystem<SystemB>());
+    ASSERT_EQ(1, world.getSystemManager().m_ExecutionList.size());
+    EXPECT_EQ(&b, world.getSystemManager().m_ExecutionList[0]);
+}
+
+TEST(NAME, RemovedSystemsAreUnregisteredImmediately)
+{
+    World world;
+    world.getSystemManager().addSystem<SystemA>();
+    world.getSystemManager().initialise();
+    world.getSystemManager().removeSystem<SystemA>();
+
+    EXPECT_EQ(false, world.getSystemManager().hasSystem<SystemA>());
+    EXPECT_EQ(1, world.getSystemManager().m_ExecutionList.size());
+}
+
+TEST(NAME, SystemsAddedAtRuntimeAreInsertedAfterTheirDependencies)
+{
+    World world;
+    System& a = world.getSystemManager().addSystem<SystemA>();
+    System& b = world.getSystemManager().addSystem<SystemB>();
+    world.getSystemManager().initialise();
+
+    System& c = world.getSystemManager().addSystem<SystemC>()
+        .executesAfter<SystemA>();
+    System& d = world.getSystemManager().addSystem<SystemD>();
+    world.update();
+    EXPECT_EQ(2, world.getSystemManager().m_ExecutionList.size());
+    world.getThreadPool().wait();
+    world.update();
+
+    const std::vector<System*>& order = world.getSystemManager().m_ExecutionList;
+    ASSERT_EQ(4, order.size());
+    EXPECT_EQ(&a, order[0]);
+    EXPECT_EQ(&c, order[1]);
+    EXPECT_EQ(&b, order[2]);
+    EXPECT_EQ(&d, order[3]);
+    EXPECT_EQ(true, c.isInitialised());
+}
+
+TEST(NAME, SystemsAddedAtRuntimeDependingOnEachOtherAreOrdered)
+{
+    World world;
+    System& a = world.getSystemManager().addSystem<SystemA>();
+    world.getSystemManager().initialise();
+
+    System& b = world.getSystemManager().addSystem<SystemB>()
+        .executesAfter<SystemC>();
+    System& c = world.getSystemManager().addSystem<SystemC>();
+
+    // SystemB only starts initialising once SystemC is done
+    world.update();
+    world.getThreadPool().wait();
+    world.update();
+    EXPECT_EQ(2, world.getSystemManager().m_ExecutionList.size());
+    world.getThreadPool().wait();
+    world.update();
+
+    const std::vector<System*>& order = world.getSystemManager().m_ExecutionList;
+    ASSERT_EQ(3, order.size());
+    EXPECT_EQ(&a, order[0]);
+    EXPECT_EQ(&c, order[1]);
+    EXPECT_EQ(&b, order[2]);
+}
+
+TEST(NAME, SystemsAddedAtRuntimeProcessExistingEntities)
+{
+    World world;
+    world.getSystemManager().initialise();
+    for(int i = 0; i != 3; ++i)
+        world.getEntityManager().createEntity("entity")
+            .addComponent<Position>(i, 0);
+    world.getEntityManager().createEntity("unsupported");
+    world.update();
+
+    OrderRecordingSystem& system = world.getSystemManager().addSystem<OrderRecordingSystem>();
+    system.supportsComponents<Position>();
+    world.update();
+    world.getThreadPool().wait();
+    world.update();
+    EXPECT_EQ(std::vector<int>({0, 1, 2}), system.order);
+}
+
+TEST(NAME, SystemsAddedAtRuntimeDontStallUpdates)
+{
+    World world;
+    world.getSystemManager().initialise();
+
+    BlockingSystem& system = world.getSystemManager().addSystem<BlockingSystem>();
+    world.update();
+    world.update();
+    EXPECT_EQ(0, world.getSystemManager().m_ExecutionList.size());
+
+    system.release = true;
+    world.getThreadPool().wait();
+    world.update();
+    ASSERT_EQ(1, world.getSystemManager().m_ExecutionList.size());
+    EXPECT_EQ(true, system.isInitialised());
+}
+
+TEST(NAME, SystemsAreInitialisedAfterTheirDependencies)
+{
+    InitialisationLog log;
+    World world;
+    world.getSystemManager().addSystem< LoggingSystem<0> >(log)
+        .executesAfter< LoggingSystem<1> >();
+    world.getSystemManager().addSystem< LoggingSystem<1> >(log)
+        .executesAfter< LoggingSystem<2> >();
+    world.getSystemManager().addSystem< LoggingSystem<2> >(log);
+    world.getSystemManager().addSystem< LoggingSystem<3> >(log);
+    world.getSystemManager().initialise();
+
+    ASSERT_EQ(4, log.order.size());
+    const auto positionOf = [&log](int system) {
+        return std::find(log.order.begin(), log.order.end(), system) - log.order.begin();
+    };
+    EXPECT_LT(positionOf(2), positionOf(1));
+    EXPECT_LT(positionOf(1), positionOf(0));
+}
+
+TEST(NAME, ConcurrentlyInitialisedSystemsWaitForTheirDependencies)
+{
+    InitialisationLog log;
+    World world;
+    world.getSystemManager().setConcurrentInitialisation(true);
+    world.getSystemManager().addSystem< LoggingSystem<0> >(log)
+        .executesAfter< LoggingSystem<1> >();
+    world.getSystemManager().addSystem< LoggingSystem<1> >(log)
+        .executesAfter< LoggingSystem<2> >();
+    world.getSystemManager().addSystem< LoggingSystem<2> >(log);
+    world.getSystemManager().addSystem< LoggingSystem<3> >(log);
+    world.getSystemManager().initialise();
+
+    ASSERT_EQ(4, log.order.size());
+    const auto positionOf = [&log](int system) {
+        return std::find(log.order.begin(), log.order.end(), system) - log.order.begin();
+    };
+    EXPECT_LT(positionOf(2), positionOf(1));
+    EXPECT_LT(positionOf(1), positionOf(0));
+}
+
+TEST(NAME, SystemsAreInitialisedOnTheCallingThreadByDefault)
+{
+    InitialisationLog log;
+    World world;
+    world.getSystemManager().addSystem< LoggingSystem<0> >(log);
+    world.getSystemManager().addSystem< LoggingSystem<1> >(log);
+    world.getSystemManager().initialise();
+
+    ASSERT_EQ(2, log.threads.size());
+    EXPECT_EQ(std::this_thread::get_id(), log.threads[0]);
+    EXPECT_EQ(std::this_thread::get_id(), log.threads[1]);
+}
+
+TEST(NAME, SystemsAreOnlyInitialisedOnce)
+{
+    InitialisationLog log;
+    World world;
+    world.getSystemManager().addSystem< LoggingSystem<0> >(log);
+    world.getSystemManager().initialise();
+    world.getSystemManager().initialise();
+
+    EXPECT_EQ(1, log.order.size());
+}
+
+TEST(NAME, FixedTimestepGroupsCatchUpWithFrameTime)
+{
+    World world;
+    SystemGroup& physics = world.getSystemManager().addGroup("Physics")
+        .setFixedTimestep(0.25f, 3);
+    CountingSystem<0>& system = world.getSystemManager().addSystem< CountingSystem<0> >();
+    system.inGroup(physics);
+    world.getSystemManager().initialise();
+
+    world.setDeltaTime(0.5f);
+    world.update();
+    EXPECT_EQ(2, system.updates);
+    EXPECT_EQ(0.25f, system.deltaTime);
+    EXPECT_EQ(0.5f, world.getDeltaTime());
+
+    world.setDeltaTime(0.125f);
+    world.update();
+    EXPECT_EQ(2, system.updates);
+    world.update();
+    EXPECT_EQ(3, system.updates);
+
+    // no more than the maximum number of steps per frame
+    world.setDeltaTime(10.0f);
+    world.update();
+    EXPECT_EQ(6, system.updates);
+}
+
+TEST(NAME, TickDivisorGroupsSpreadSystemsAcrossFrames)
+{
+    World world;
+    SystemGroup& ai = world.getSystemManager().addGroup("AI")
+        .setTickDivisor(2);
+    CountingSystem<0>& a = world.getSystemManager().addSystem< CountingSystem<0> >();
+    CountingSystem<1>& b = world.getSystemManager().addSystem< CountingSystem<1> >();
+    CountingSystem<2>& c = world.getSystemManager().addSystem< CountingSystem<2> >();
+    a.inGroup(ai);
+    b.inGroup(ai);
+    world.getSystemManager().initialise();
+
+    world.setDeltaTime(1.0f);
+    world.update();
+    EXPECT_EQ(1, a.updates);
+    EXPECT_EQ(0, b.updates);
+    EXPECT_EQ(1, c.updates);
+
+    world.update();
+    EXPECT_EQ(1, a.updates);
+    EXPECT_EQ(1, b.updates);
+    EXPECT_EQ(2, c.updates);
+
+    // systems receive the time elapsed over the last two frames
+    EXPECT_EQ(2.0f, b.deltaTime);
+    EXPECT_EQ(1.0f, c.deltaTime);
+}
+
+TEST(NAME, GroupsRunAfterTheDependenciesOfAllTheirSystems)
+{
+    World world;
+    SystemGroup& group = world.getSystemManager().addGroup("Group");
+    System& first = world.getSystemManager().addSystem<SystemA>()
+        .inGroup(group);
+    System& other = world.getSystemManager().addSystem<SystemB>();
+    System& second = world.getSystemManager().addSystem<SystemC>()
+        .executesAfter<SystemB>()
+        .inGroup(group);
+    world.getSystemManager().initialise();
+    world.update();
+
+    const std::vector<System*>& order = world.getSystemManager().m_ExecutionList;
+    ASSERT_EQ(3, order.size());
+    EXPECT_EQ(&other, order[0]);
+    EXPECT_EQ(&first, order[1]);
+    EXPECT_EQ(&second, order[2]);
+}
+
+TEST(NAME, SystemsAreSkippedWhenPredicateFails)
+{
+    bool enabled = false;
+    World world;
+    CountingSystem<0>& system = world.getSystemManager().addSystem< CountingSystem<0> >();
+    system.runIf([&enabled](World&) { return enabled; });
+    world.getSystemManager().initialise();
+
+    world.update();
+    EXPECT_EQ(0, system.updates);
+    enabled = true;
+    world.update();
+    EXPECT_EQ(1, system.updates);
+}
+
+TEST(NAME, EmptySystemsAreSkipped)
+{
+    World world;
+    CountingSystem<0>& system = world.getSystemManager().addSystem< CountingSystem<0> >();
+    system.supportsComponents<Position>()
+        .skipsWhenEmpty();
+    world.getSystemManager().initialise();
+
+    world.update();
+    EXPECT_EQ(0, system.updates);
+    world.getEntityManager().createEntity("entity")
+        .addComponent<Position>(0, 0);
+    world.update();
+    EXPECT_EQ(1, system.updates);
+}
+
+TEST(NAME, SystemsOnlyRunIfDependenciesChanged)
+{
+    World world;
+    world.getSystemManager().addSystem< CountingSystem<0> >()
+        .writes<Velocity>();
+    CountingSystem<1>& system = world.getSystemManager().addSystem< CountingSystem<1> >();
+    system.runIfChanged<Position>();
+    world.getSystemManager().initialise();
+
+    world.update();
+    EXPECT_EQ(0, system.updates);
+
+    // adding a component changes the type
+    Entity::ID entity = world.getEntityManager().createEntity("entity")
+        .addComponent<Position>(0, 0)
+        .getID();
+    world.update();
+    EXPECT_EQ(1, system.updates);
+    world.update();
+    EXPECT_EQ(1, system.updates);
+
+    // changes made outside of systems have to be flagged
+    world.getEntityManager().getEntity(entity).getComponent<Position>().x = 3;
+    world.markChanged<Position>();
+    world.update();
+    EXPECT_EQ(2, system.updates);
+}
+
+TEST(NAME, BudgetedSystemsRunUntilTheyCaughtUpWithChanges)
+{
+    World world;
+    CountingSystem<0>& system = world.getSystemManager().addSystem< CountingSystem<0> >();
+    system.supportsComponents<Position>()
+        .runIfChanged<Position>()
+        .setEntityBudget(2);
+    world.getSystemManager().initialise();
+    for(int i = 0; i != 5; ++i)
+        world.getEntityManager().createEntity("entity")
+            .addComponent<Position>(0, 0);
+
+    // entities 0-1, then 2-3, then 4 and 0 after wrapping around
+    world.update();
+    world.update();
+    EXPECT_EQ(2, system.updates);
+    world.update();
+    EXPECT_EQ(4, system.updates);
+    world.update();
+    EXPECT_EQ(4, system.updates);
+}
+
+TEST(NAME, ChangeIDsAreDensePerType)
+{
+    const TypeID position = World::getChangeID(&typeid(Position));
+    EXPECT_EQ(position, World::getChangeID(&typeid(Position)));
+    EXPECT_NE(position, World::getChangeID(&typeid(Velocity)));
+
+    World world;
+    EXPECT_EQ(0, world.getChangeTick(position));
+    world.markChanged<Position>();
+    EXPECT_EQ(world.getChangeTick(), world.getChangeTick(position));
+    EXPECT_EQ(world.getChangeTick(), world.getChangeTick(&typeid(Position)));
+}
+
+TEST(NAME, SystemsDeclaringWritesChangeTypes)
+{
+    World world;
+    world.getSystemManager().addSystem< CountingSystem<0> >()
+        .supportsComponents<Velocity>()
+        .writes<Velocity>();
+    CountingSystem<1>& system = world.getSystemManager().addSystem< CountingSystem<1> >();
+    system.runIfChanged<Velocity>();
+    world.getSystemManager().initialise();
+    world.getEntityManager().createEntity("entity")
+        .addComponent<Velocity>(0, 0);
+
+    world.update();
+    world.update();
+    EXPECT_EQ(2, system.updates);
+}
+
+TEST(NAME, SystemsWithoutEntitiesDontChangeTypes)
+{
+    World world;
+    world.getSystemManager().addSystem< CountingSystem<0> >()
+        .supportsComponents<Velocity>()
+        .writes<Velocity>();
+    CountingSystem<1>& system = world.getSystemManager().addSystem< CountingSystem<1> >();
+    system.runIfChanged<Velocity>();
+    world.getSystemManager().initialise();
+
+    world.update();
+    world.update();
+    EXPECT_EQ(0, system.updates);
+}
+
+TEST(NAME, CommandBuffersAreAppliedInChunkOrder)
+{
+    for(std::size_t threadCount = 1; threadCount != 5; ++threadCount)
+    {
+        World world;
+        world.setDeterministic(true);
+        world.getThreadPool().setThreadCount(threadCount);
+        RecordingSystem& system = world.getSystemManager().addSystem<RecordingSystem>();
+        system.supportsComponents<Position>()
+            .setExecutionPolicy(ExecutionPolicy::Parallel, 7);
+        world.getSystemManager().initialise();
+
+        std::vector<Entity::ID> expected;
+        for(int i = 0; i != 100; ++i)
+            expected.push_back(world.getEntityManager().createEntity("entity")
+                .addComponent<Position>(i, i)
+                .getID());
+        world.update();
+
+        EXPECT_EQ(expected, system.recorded);
+    }
+}
+
+TEST(NAME, CommandBuffersModifyWorldAfterUpdate)
+{
+    World world;
+    world.getSystemManager().addSystem<DestroyingSystem>()
+        .supportsComponents<Position>();
+    world.getSystemManager().initialise();
+    for(int i = 0; i != 10; ++i)
+        world.getEntityManager().createEntity("entity")
+            .addComponent<Position>(i, i)
+            .addComponent<Velocity>(i, i);
+
+    world.update();
+    EXPECT_EQ(0, world.getEntityManager().m_EntityList.size());
+}
+
+TEST(NAME, CommandBuffersAddTagComponents)
+{
+    World world;
+    world.getSystemManager().addSystem<MarkingSystem>()
+        .supportsComponents<Position>();
+    world.getSystemManager().initialise();
+    Entity& entity = world.getEntityManager().createEntity("entity")
+        .addComponent<Position>(0, 0);
+
+    world.update();
+    EXPECT_EQ(true, entity.hasComponent<Marked>());
+}
+
+TEST(NAME, ReductionsAreMergedAfterUpdate)
+{
+    World world;
+    world.getThreadPool().setThreadCount(4);
+    ReducingSystem& system = world.getSystemManager().addSystem<ReducingSystem>();
+    system.supportsComponents<Position>()
+        .setExecutionPolicy(ExecutionPolicy::Parallel, 7);
+    world.getSystemManager().initialise();
+    for(int i = 0; i != 100; ++i)
+        world.getEntityManager().createEntity("entity")
+            .addComponent<Position>(i, i);
+
+    world.update();
+    EXPECT_EQ(100, system.count.get());
+    EXPECT_EQ(99, system.maxX.get());
+
+    // accumulators start over with every update
+    world.update();
+    EXPECT_EQ(100, system.count.get());
+}
+
+TEST(NAME, BudgetedReductionsAccumulateWholePasses)
+{
+    World world;
+    ReducingSystem& system = world.getSystemManager().addSystem<ReducingSystem>();
+    system.supportsComponents<Position>()
+        .setEntityBudget(3);
+    world.getSystemManager().initialise();
+    for(int i = 0; i != 5; ++i)
+        world.getEntityManager().createEntity("entity")
+            .addComponent<Position>(i, i);
+
+    world.update();
+    EXPECT_EQ(0, system.count.get());
+    world.update();
+    EXPECT_EQ(5, system.count.get());
+    EXPECT_EQ(4, system.maxX.get());
+    world.update();
+    EXPECT_EQ(5, system.count.get());
+}
+
+TEST(NAME, EntitiesAreProcessedInKeyOrder)
+{
+    World world;
+    OrderRecordingSystem& system = world.getSystemManager().addSystem<OrderRecordingSystem>();
+    system.supportsComponents<Position>()
+        .sortsEntitiesBy<Position>([](const Position& position) { return position.x; });
+    world.getSystemManager().initialise();
+
+    std::vector<Entity::ID> entities;
+    for(int i = 0; i != 200; ++i)
+        entities.push_back(world.getEntityManager().createEntity("entity")
+            .addComponent<Position>((i * 37) % 200, 0)
+            .getID());
+    world.update();
+    std::vector<int> expected;
+    for(int i = 0; i != 200; ++i)
+        expected.push_back(i);
+    EXPECT_EQ(expected, system.order);
+
+    // small changes are fixed up incrementally
+    world.getEntityManager().getEntity(entities[1]).getComponent<Position>().x = -1;
+    system.order.clear();
+    world.update();
+    EXPECT_EQ(-1, system.order.front());
+    EXPECT_TRUE(std::is_sorted(system.order.begin(), system.order.end()));
+}
+
+TEST(NAME, EntitiesAreSortedByKeysOfAnyType)
+{
+    World world;
+    OrderRecordingSystem& system = world.getSystemManager().addSystem<OrderRecordingSystem>();
+    system.supportsComponents<Position>()
+        .sortsEntitiesBy<Position>([](const Position& position) {
+            return std::make_pair(position.y, position.x);
+        });
+    world.getSystemManager().initialise();
+    for(int i = 0; i != 6; ++i)
+        world.getEntityManager().createEntity("entity")
+            .addComponent<Position>(i, i % 2);
+
+    world.update();
+    EXPECT_EQ(std::vector<int>({0, 2, 4, 1, 3, 5}), system.order);
+}
+
+TEST(NAME, EntitiesAreSortedBySharedComponents)
+{
+    World world;
+    OrderRecordingSystem& system = world.getSystemManager().addSystem<OrderRecordingSystem>();
+    system.supportsComponents<Position, Friction>()
+        .sortsEntitiesBy<Friction>([](const Friction& friction) { return friction.value; });
+    world.getSystemManager().initialise();
+    const int frictions[] = {3, 1, 2};
+    for(int i = 0; i != 3; ++i)
+        world.getEntityManager().createEntity("entity")
+            .addComponent<Position>(i, 0)
+            .addSharedComponent<Friction>(frictions[i]);
+
+    world.update();
+    EXPECT_EQ(std::vector<int>({1, 2, 0}), system.order);
+}
+
+TEST(NAME, BudgetedSystemsOnlySortBetweenPasses)
+{
+    World world;
+    OrderRecordingSystem& system = world.getSystemManager().addSystem<OrderRecordingSystem>();
+    system.supportsComponents<Position>()
+        .sortsEntitiesBy<Position>([](const Position& position) { return position.y; })
+        .setEntityBudget(2);
+    world.getSystemManager().initialise();
+    std::vector<Entity::ID> entities;
+    for(int i = 0; i != 4; ++i)
+        entities.push_back(world.getEntityManager().createEntity("entity")
+            .addComponent<Position>(i, i)
+            .getID());
+    world.update();
+
+    // reversing the order mid-pass must not skip or repeat entities
+    for(int i = 0; i != 4; ++i)
+        world.getEntityManager().getEntity(entities[i]).getComponent<Position>().y = -i;
+    world.update();
+    world.update();
+    EXPECT_EQ(std::vector<int>({0, 1, 2, 3, 3, 2}), system.order);
+}
+
+TEST(NAME, EntityListOnlyChangesWithListedEntities)
+{
+    World world;
+    ListChangeCountingSystem& system = world.getSystemManager().addSystem<ListChangeCountingSystem>();
+    system.supportsComponents<Position>();
+    world.getSystemManager().initialise();
+    Entity::ID listed = world.getEntityManager().createEntity("listed")
+        .addComponent<Position>(0, 0)
+        .getID();
+    Entity::ID other = world.getEntityManager().createEntity("other").getID();
+    world.update();
+    EXPECT_EQ(1, system.changes);
+
+    world.getEntityManager().getEntity(other).addComponent<Velocity>(0, 0);
+    world.update();
+    EXPECT_EQ(1, system.changes);
+
+    world.getEntityManager().getEntity(listed).addComponent<Velocity>(0, 0);
+    world.update();
+    EXPECT_EQ(2, system.changes);
+}
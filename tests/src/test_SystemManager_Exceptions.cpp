@@ -0,0 +1,59 @@
+#include <tests/TestFixture_SystemManager.hpp>
+
+#ifdef TESTS_WITH_EXCEPTIONS
+
+// ----------------------------------------------------------------------------
+// tests
+// ----------------------------------------------------------------------------
+
+TEST(NAME, GettingNonExistingSystemThrowsInvalidSystemException)
+{
+    World world;
+    ASSERT_THROW(world.getSystemManager().getSystem<SystemA>(), InvalidSystemException);
+}
+
+TEST(NAME, DependingOnNonExistingSystemThrowsInvalidSystemException)
+{
+    World world;
+    world.getSystemManager().addSystem<SystemA>()
+        .executesAfter<SystemB>();
+    ASSERT_THROW(world.getSystemManager().initialise(), InvalidSystemException);
+}
+
+TEST(NAME, CircularDependencyThrowsCircularDependencyException)
+{
+    World world;
+    world.getSystemManager().addSystem<SystemA>()
+        .executesAfter<SystemC>();
+    world.getSystemManager().addSystem<SystemB>()
+        .executesAfter<SystemA>();
+    world.getSystemManager().addSystem<SystemC>()
+        .executesAfter<SystemB>();
+    ASSERT_THROW(world.getSystemManager().initialise(), CircularDependencyException);
+}
+
+TEST(NAME, GroupsSurroundingADependencyThrowCircularDependencyException)
+{
+    World world;
+    SystemGroup& group = world.getSystemManager().addGroup("Group");
+    world.getSystemManager().addSystem<SystemA>()
+        .inGroup(group);
+    world.getSystemManager().addSystem<SystemB>()
+        .executesAfter<SystemA>();
+    world.getSystemManager().addSystem<SystemC>()
+        .executesAfter<SystemB>()
+        .inGroup(group);
+    ASSERT_THROW(world.getSystemManager().initialise(), CircularDependencyException);
+}
+
+TEST(NAME, RemovingSystemOthersDependOnThrowsInvalidSystemException)
+{
+    World world;
+    world.getSystemManager().addSystem<SystemA>();
+    world.getSystemManager().addSystem<SystemB>()
+        .executesAfter<SystemA>();
+    world.getSystemManager().initialise();
+    ASSERT_THROW(world.getSystemManager().removeSystem<SystemA>(), InvalidSystemException);
+}
+
+#endif // TESTS_WITH_EXCEPTIONS
@@ -0,0 +1,116 @@
+#include <gmock/gmock.h>
+#include <ontology/ThreadPool.hpp>
+
+#include <atomic>
+#include <stdexcept>
+
+#define NAME ThreadPool
+
+using namespace Ontology;
+
+// ----------------------------------------------------------------------------
+// tests
+// ----------------------------------------------------------------------------
+
+TEST(NAME, ThreadsAreOnlyStartedWhenTasksAreQueued)
+{
+    ThreadPool pool(4);
+    EXPECT_EQ(4, pool.getThreadCount());
+    EXPECT_EQ(0, pool.m_Threads.size());
+    pool.enqueue([]() {});
+    EXPECT_EQ(4, pool.m_Threads.size());
+    pool.wait();
+}
+
+TEST(NAME, WaitBlocksUntilAllTasksFinished)
+{
+    std::atomic<int> counter(0);
+    ThreadPool pool(3);
+    for(int i = 0; i != 100; ++i)
+        pool.enqueue([&counter]() { ++counter; });
+    pool.wait();
+    EXPECT_EQ(100, counter.load());
+}
+
+TEST(NAME, WaitIncludesTasksQueuedByTasks)
+{
+    std::atomic<int> counter(0);
+    ThreadPool pool(2);
+    pool.enqueue([&pool, &counter]() {
+        for(int i = 0; i != 10; ++i)
+            pool.enqueue([&counter]() { ++counter; });
+    });
+    pool.wait();
+    EXPECT_EQ(10, counter.load());
+}
+
+TEST(NAME, WaitRethrowsExceptionsThrownByTasks)
+{
+    ThreadPool pool(2);
+    pool.enqueue([]() { throw std::runtime_error("failed"); });
+    EXPECT_THROW(pool.wait(), std::runtime_error);
+
+    // the pool remains usable afterwards
+    std::atomic<int> counter(0);
+    pool.enqueue([&counter]() { ++counter; });
+    pool.wait();
+    EXPECT_EQ(1, counter.load());
+}
+
+TEST(NAME, ParallelForProcessesEveryIndexOnce)
+{
+    std::vector< std::atomic<int> > visits(1000);
+    ThreadPool pool(4);
+    pool.parallelFor(visits.size(), 7, [&visits](std::size_t first, std::size_t last) {
+        for(std::size_t i = first; i != last; ++i)
+            ++visits[i];
+    });
+    for(const auto& count : visits)
+        ASSERT_EQ(1, count.load());
+}
+
+TEST(NAME, ParallelForCanBeNestedInTasks)
+{
+    std::atomic<int> counter(0);
+    ThreadPool pool(2);
+    for(int task = 0; task != 4; ++task)
+        pool.enqueue([&pool, &counter]() {
+            pool.parallelFor(100, 10, [&counter](std::size_t first, std::size_t last) {
+                counter += static_cast<int>(last - first);
+            });
+        });
+    pool.wait();
+    EXPECT_EQ(400, counter.load());
+}
+
+TEST(NAME, ParallelForRethrowsExceptions)
+{
+    ThreadPool pool(2);
+    EXPECT_THROW(
+        pool.parallelFor(10, 1, [](std::size_t first, std::size_t) {
+            if(first == 5)
+                throw std::runtime_error("failed");
+        }),
+        std::runtime_error
+    );
+}
+
+TEST(NAME, ParallelReduceIsIndependentOfThreadCount)
+{
+    std::vector<float> values;
+    for(int i = 0; i != 10000; ++i)
+        values.push_back(1.0f / (1 + i % 97));
+
+    ThreadPool serial(1);
+    const float expected = serial.parallelReduce(values.size(), 64, 0.0f,
+        [&values](std::size_t i) { return values[i]; },
+        [](float a, float b) { return a + b; });
+    for(std::size_t threadCount = 2; threadCount != 6; ++threadCount)
+    {
+        ThreadPool pool(threadCount);
+        const float result = pool.parallelReduce(values.size(), 64, 0.0f,
+            [&values](std::size_t i) { return values[i]; },
+            [](float a, float b) { return a + b; });
+        EXPECT_EQ(expected, result);
+    }
+}
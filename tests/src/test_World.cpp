@@ -1,14 +1,52 @@
-#include <gmock/gmock.h>
-#include <ontology/Ontology.hpp>
-
-#define NAME World
-
-using namespace Ontology;
-
-// ----------------------------------------------------------------------------
-// test fixture
-// ----------------------------------------------------------------------------
+#include <tests/TestFixture_World.hpp>
 
 // ----------------------------------------------------------------------------
 // tests
 // ----------------------------------------------------------------------------
+
+TEST(NAME, AddingSingletonsMakesThemAccessible)
+{
+    World world;
+    ASSERT_EQ(false, world.hasSingleton<Camera>());
+
+    world.addSingleton<Camera>(3, 4);
+    ASSERT_EQ(true, world.hasSingleton<Camera>());
+    ASSERT_EQ(false, world.hasSingleton<Input>());
+    EXPECT_EQ(3, world.singleton<Camera>().x);
+    EXPECT_EQ(4, world.singleton<Camera>().y);
+
+    world.singleton<Camera>().x = 10;
+    EXPECT_EQ(10, world.singleton<Camera>().x);
+}
+
+TEST(NAME, SingletonsAreStoredPerWorld)
+{
+    World world1, world2;
+    world1.addSingleton<Input>().pressed = true;
+    world2.addSingleton<Input>();
+
+    EXPECT_EQ(true, world1.singleton<Input>().pressed);
+    EXPECT_EQ(false, world2.singleton<Input>().pressed);
+}
+
+TEST(NAME, RemovingSingletons)
+{
+    World world;
+    world.addSingleton<Input>();
+    world.removeSingleton<Input>();
+    ASSERT_EQ(false, world.hasSingleton<Input>());
+    world.removeSingleton<Camera>(); // does nothing
+}
+
+TEST(NAME, LoggerReceivesSystemMessages)
+{
+    std::vector<std::string> messages;
+    World world;
+    world.setLogger([&messages](const std::string& message) {
+        messages.push_back(message);
+    });
+    world.log("hello");
+
+    ASSERT_EQ(1, messages.size());
+    EXPECT_EQ(std::string("hello"), messages[0]);
+}
@@ -0,0 +1,28 @@
+#include <tests/TestFixture_World.hpp>
+
+#ifdef TESTS_WITH_EXCEPTIONS
+
+// ----------------------------------------------------------------------------
+// tests
+// ----------------------------------------------------------------------------
+
+TEST(NAME, GettingNonExistingSingletonThrowsInvalidSingletonException)
+{
+    World world;
+    ASSERT_THROW(world.singleton<Camera>(), InvalidSingletonException);
+}
+
+TEST(NAME, AddingTwoSingletonsOfTheSameTypeThrowsDuplicateSingletonException)
+{
+    World world;
+    world.addSingleton<Input>();
+    ASSERT_THROW(world.addSingleton<Input>(), DuplicateSingletonException);
+}
+
+TEST(NAME, QueryingWithoutSpatialIndexThrowsInvalidSpatialIndexException)
+{
+    World world;
+    ASSERT_THROW(world.queryRadius(SpatialIndex::Point(), 1.0f), InvalidSpatialIndexException);
+}
+
+#endif // TESTS_WITH_EXCEPTIONS